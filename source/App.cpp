@@ -2,7 +2,7 @@
 #include <oatpp/network/Server.hpp>
 #include <oatpp/network/tcp/server/ConnectionProvider.hpp>
 #include <oatpp/parser/json/mapping/ObjectMapper.hpp>
-#include <oatpp/web/server/HttpConnectionHandler.hpp>
+#include <oatpp/web/server/AsyncHttpConnectionHandler.hpp>
 
 #include <omp.h>
 
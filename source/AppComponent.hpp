@@ -6,7 +6,6 @@
 #include "oatpp/network/tcp/server/ConnectionProvider.hpp"
 #include "oatpp/parser/json/mapping/ObjectMapper.hpp"
 #include "oatpp/web/server/AsyncHttpConnectionHandler.hpp"
-#include "oatpp/web/server/HttpConnectionHandler.hpp"
 
 #include "imp/Settings.hpp"
 
@@ -34,6 +33,14 @@ public:
              oatpp::network::Address::IP_4});
     }());
 
+    // Create Executor component which runs the endpoint coroutines
+    OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::async::Executor>, executor)
+    ([] {
+        return std::make_shared<oatpp::async::Executor>(SERVER_ASYNC_WORKERS, // processor
+                                                        1,                    // io
+                                                        1);                   // timer
+    }());
+
     // Create Router component
     OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::web::server::HttpRouter>, httpRouter)
     ([] { return oatpp::web::server::HttpRouter::createShared(); }());
@@ -44,7 +51,8 @@ public:
     ([] {
         OATPP_COMPONENT(std::shared_ptr<oatpp::web::server::HttpRouter>,
                         router); // get Router component
-        return oatpp::web::server::HttpConnectionHandler::createShared(router);
+        OATPP_COMPONENT(std::shared_ptr<oatpp::async::Executor>, executor);
+        return oatpp::web::server::AsyncHttpConnectionHandler::createShared(router, executor);
     }());
 
     // Create ObjectMapper component to serialize/deserialize DTOs in Contoller's API
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <concepts>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "imp/Configuration.hpp"
@@ -53,24 +55,31 @@ public:
 };
 
 /**
- * @brief Data structure to use with CKDTree.
+ * @brief Data structure to use with CKDTree. Kept trivially copyable so node buffers can be
+ * copied as a whole, see imp::json::__makeJSON for its JSON export.
  *
  * @author Ronja Schnur (rschnur@students.uni-mainz.de)
  */
-struct CKDData : public imp::json::JSONable
+struct CKDData
 {
 public:
-    JSON_IMPL(JSOND(Config) JSON(Rating))
-
-public:
-    Configuration Config;
-    size_t Rating{0};
+    Pose Config;
+    uint32_t Rating{0};
 
 public:
     CKDData() = default;
     CKDData(const Configuration & c) : Config{c}, Rating{0} {}
 };
 
+static_assert(std::is_trivially_copyable_v<CKDData>);
+
+/**
+ * @brief Requirements for the data stored in a CKDTree.
+ */
+template <class storage_t>
+concept CKDStorable = std::derived_from<storage_t, CKDData> &&
+                      std::is_trivially_copyable_v<storage_t>;
+
 using CKDDistancePair = std::pair<float, float>;
 
 /**
@@ -142,12 +151,11 @@ public:
 /**
  * @brief A KD Tree implementation on 7 Dimensions for the configuration space.
  *
- * @tparam storage_t             The type the data is stored in
- * @tparam access_f(storage_t &) The function the access the configuration from the storage_t
+ * @tparam storage_t   The type the data is stored in
+ * @tparam container_t Random access container of storage_t (size() and operator[])
  * @author Ronja Schnur (rschnur@students.uni-mainz.de)
  */
-template <class storage_t>
-requires std::derived_from<storage_t, CKDData>
+template <CKDStorable storage_t, class container_t = std::vector<storage_t>>
 class CKDTree : public imp::json::JSONable
 {
     /////////
@@ -158,7 +166,7 @@ public:
         auto & Root{_root};          //
         auto & Size{_size};          //
         auto & LeafSize{_LEAF_SIZE}; //
-        auto & Data{_data};          //
+        auto & Data{*_data};         //
         JSOND(Root)                  //
         JSOND(Data)                  //
         JSOND(Size)                  //
@@ -179,8 +187,8 @@ private:
 
     // marks until which value configurations used in the tree
     size_t _explored_size{0};
-    // The vector in which the configurations are stored
-    std::vector<storage_t> & _data;
+    // The container in which the configurations are stored
+    container_t * _data;
 
     // number of elements in the tree
     size_t _size{0};
@@ -189,14 +197,19 @@ private:
     // constructors
     /////////
 public:
-    CKDTree(std::vector<storage_t> & data,       //
+    /**
+     * @param INDEX Whether the present data is indexed (and rated) right away, point by point.
+     * Otherwise it is left to insertBulk(), which keeps the stored ratings.
+     */
+    CKDTree(container_t & data,                  //
             const CKDTreeBox & BOX,              //
             const imp::DistancePair & DISTANCES, //
-            const size_t LEAF_SIZE = 1024)
-        : _DISTANCES{DISTANCES}, _BOX{BOX}, _LEAF_SIZE{LEAF_SIZE}, _data{data}
+            const size_t LEAF_SIZE = 1024,       //
+            const bool INDEX = true)
+        : _DISTANCES{DISTANCES}, _BOX{BOX}, _LEAF_SIZE{LEAF_SIZE}, _data{&data}
     {
         _root = std::make_shared<CKDTreeNode>(BOX);
-        revalidate();
+        if (INDEX) revalidate();
     }
 
     /////////
@@ -245,7 +258,7 @@ protected:
         // partition points
         size_t MIDDLE =
             std::partition(points.begin() + BEGIN, points.begin() + END,
-                           [&](size_t & k) { return _data[k].Config[direction] <= split; }) -
+                           [&](size_t & k) { return (*_data)[k].Config[direction] <= split; }) -
             points.begin();
 
         // create children
@@ -284,11 +297,15 @@ protected:
         if (node->Left) node->Points.clear();
     }
 
-    template <bool RATING>
+    /**
+     * @brief Counts the points within the given distances, calling visit(index) for each.
+     */
+    template <class visitor_t>
     size_t search(std::shared_ptr<CKDTreeNode> node, //
                   Configuration & c_near,            //
                   Configuration & c,                 //
-                  const DistancePair & distances)
+                  const DistancePair & distances,    //
+                  const visitor_t & visit) const
     {
         if (!node) return 0;
 
@@ -297,11 +314,11 @@ protected:
         {
             for (size_t i : node->Points)
             {
-                auto pair = PairDistance(_data[i].Config, c);
+                auto pair = PairDistance((*_data)[i].Config, c);
                 if (pair.first < distances.first && pair.second < distances.second)
                 {
                     result++;
-                    if (RATING) _data[i].Rating += 1;
+                    visit(i);
                 }
             }
         }
@@ -312,20 +329,20 @@ protected:
             const float BACKUP{c_near[DIRECTION]};
             if (c[DIRECTION] <= SPLIT)
             {
-                result += search<RATING>(node->Left, c_near, c, distances);
+                result += search(node->Left, c_near, c, distances, visit);
                 c_near[DIRECTION] = SPLIT;
                 auto pair = PairDistance(c_near, c);
                 if (pair.first < distances.first && pair.second < distances.second)
-                    result += search<RATING>(node->Right, c_near, c, distances);
+                    result += search(node->Right, c_near, c, distances, visit);
                 c_near[DIRECTION] = BACKUP;
             }
             else
             {
-                result += search<RATING>(node->Right, c_near, c, distances);
+                result += search(node->Right, c_near, c, distances, visit);
                 c_near[DIRECTION] = SPLIT;
                 auto pair = PairDistance(c_near, c);
                 if (pair.first < distances.first && pair.second < distances.second)
-                    result += search<RATING>(node->Left, c_near, c, distances);
+                    result += search(node->Left, c_near, c, distances, visit);
                 c_near[DIRECTION] = BACKUP;
             }
         }
@@ -333,10 +350,12 @@ protected:
         return result;
     }
 
-    template <bool RATING> size_t search(imp::Configuration c, const DistancePair & distances)
+    template <class visitor_t>
+    size_t search(imp::Configuration c, const DistancePair & distances,
+                  const visitor_t & visit) const
     {
         imp::Configuration c_near{c};
-        size_t result{search<RATING>(_root, c_near, c, distances)};
+        size_t result{search(_root, c_near, c, distances, visit)};
         c.Rotation.x() *= -1.0f;
         c.Rotation.y() *= -1.0f;
         c.Rotation.z() *= -1.0f;
@@ -345,15 +364,23 @@ protected:
         c_near.Rotation.y() *= -1.0f;
         c_near.Rotation.z() *= -1.0f;
         c_near.Rotation.w() *= -1.0f;
-        return result + search<RATING>(_root, c_near, c, distances);
+        return result + search(_root, c_near, c, distances, visit);
+    }
+
+    size_t memoryUsage(const std::shared_ptr<CKDTreeNode> & node) const
+    {
+        if (!node) return 0;
+        return sizeof(CKDTreeNode) + node->Points.capacity() * sizeof(size_t) +
+               memoryUsage(node->Left) + memoryUsage(node->Right);
     }
 
     bool expand()
     {
-        if (_data.size() == _size) return false;
+        if (_data->size() == _size) return false;
 
-        auto & c{_data[_size]};
-        _data[_size].Rating = search<true>(c.Config, _DISTANCES);
+        auto & c{(*_data)[_size]};
+        (*_data)[_size].Rating = search(c.Config, _DISTANCES,
+                                        [this](const size_t i) { (*_data)[i].Rating += 1; });
         auto node = findNode(c.Config);
 
         node->Points.emplace_back(_size++);
@@ -368,6 +395,65 @@ public:
         while (expand())
         {}
     }
+
+    /**
+     * @brief Indexes all data appended since the last update at once. The points are routed to
+     * their leaves and every overflowing leaf is split once afterwards. Ratings already stored
+     * in the data are kept instead of being recomputed.
+     */
+    void insertBulk()
+    {
+        std::vector<std::shared_ptr<CKDTreeNode>> overflowing;
+        for (; _size < _data->size(); ++_size)
+        {
+            auto node = findNode((*_data)[_size].Config);
+            node->Points.emplace_back(_size);
+            if (node->Points.size() == _LEAF_SIZE + 1) overflowing.emplace_back(node);
+        }
+
+        for (auto & node : overflowing) growSubtree(node);
+    }
+
+    /**
+     * @brief Points the tree to another container holding the same data (e.g. after the
+     * container was moved).
+     */
+    void rebind(container_t & data) { _data = &data; }
+
+    /**
+     * @brief Approximate number of bytes used by the tree structure (without the data vector).
+     */
+    size_t memoryUsage() const { return memoryUsage(_root); }
+
+    /**
+     * @brief Indices of all points whose positional and rotational distances to c are below the
+     * given distances. Does not modify the tree and may be called concurrently.
+     */
+    std::vector<size_t> within(const Configuration & c, const DistancePair & distances) const
+    {
+        std::vector<size_t> result;
+        search(c, distances, [&result](const size_t i) { result.emplace_back(i); });
+
+        // both quaternion hemispheres are searched
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
 };
 
-} // namespace imp
\ No newline at end of file
+} // namespace imp
+
+namespace imp::json
+{
+
+template <> inline std::string __makeJSON(const imp::CKDData * v)
+{
+    std::stringstream ss;
+    ss << "{";
+    JSONND(Config, v->Config)
+    JSONN(Rating, v->Rating)
+    ss << "}";
+    return ss.str();
+}
+
+} // namespace imp::json
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+
+namespace imp
+{
+
+/**
+ * @brief Cooperative cancellation flag, polled by long running loops (explorations, path
+ * validation). A token may be linked to a parent, it then also counts as cancelled once the
+ * parent is.
+ */
+class CancellationToken
+{
+    /////////
+    // data
+    /////////
+private:
+    std::atomic<bool> _cancelled{false};
+    const CancellationToken * _parent{nullptr};
+
+    /////////
+    // constructors
+    /////////
+public:
+    CancellationToken() = default;
+    explicit CancellationToken(const CancellationToken * parent) : _parent{parent} {}
+
+    CancellationToken(const CancellationToken &) = delete;
+    CancellationToken & operator=(const CancellationToken &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    inline void cancel() { _cancelled.store(true, std::memory_order_release); }
+
+    inline bool cancelled() const
+    {
+        return _cancelled.load(std::memory_order_acquire) || (_parent && _parent->cancelled());
+    }
+
+    /**
+     * @brief Rearms the token (and relinks it). Must not race with cancelled(), cancel() may be
+     * called concurrently.
+     */
+    inline void reset(const CancellationToken * parent = nullptr)
+    {
+        _parent = parent;
+        _cancelled.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Drops the parent link, the own state is kept. Must not race with cancelled().
+     */
+    inline void unlink() { _parent = nullptr; }
+};
+
+/**
+ * @brief Links a token to a parent during its lifetime (rearming it), the parent only has to
+ * outlive the link.
+ */
+class CancellationLink
+{
+    /////////
+    // data
+    /////////
+private:
+    CancellationToken & _token;
+
+    /////////
+    // constructors
+    /////////
+public:
+    CancellationLink(CancellationToken & token, const CancellationToken * parent) : _token{token}
+    {
+        _token.reset(parent);
+    }
+    ~CancellationLink() { _token.unlink(); }
+
+    CancellationLink(const CancellationLink &) = delete;
+    CancellationLink & operator=(const CancellationLink &) = delete;
+};
+
+} // namespace imp
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "imp/json/JSON.hpp"
+
+namespace imp
+{
+
+/**
+ * @brief Vector stored as a list of contiguous chunks. Whole buffers can be adopted by moving
+ * them in (O(1), no element is copied), each chunk carries user meta data (e.g. how its
+ * elements have to be interpreted). Element access searches the chunk, keep the number of
+ * chunks small by merging them with assign.
+ *
+ * @tparam value_t The element type
+ * @tparam meta_t  Per chunk meta data, default constructed for chunks grown by emplace_back
+ */
+template <class value_t, class meta_t> class ChunkedVector
+{
+    /////////
+    // nested
+    /////////
+public:
+    struct Chunk
+    {
+        std::vector<value_t> Data;
+        size_t Base{0};      // index of the first element
+        meta_t Meta{};       //
+        bool Sealed{false};  // adopted chunks are never extended
+    };
+
+    /////////
+    // data
+    /////////
+private:
+    std::vector<Chunk> _chunks;
+    size_t _size{0};
+
+    /////////
+    // properties
+    /////////
+public:
+    inline size_t size() const noexcept { return _size; }
+    inline bool empty() const noexcept { return !_size; }
+    inline const std::vector<Chunk> & chunks() const noexcept { return _chunks; }
+
+    size_t capacity() const noexcept
+    {
+        size_t result{0};
+        for (const auto & chunk : _chunks) result += chunk.Data.capacity();
+        return result;
+    }
+
+    /////////
+    // methods
+    /////////
+public:
+    const Chunk & chunkOf(const size_t I) const
+    {
+        if (_chunks.back().Base <= I) return _chunks.back(); // most accesses hit recent data
+        return *(std::upper_bound(_chunks.begin(), _chunks.end(), I,
+                                  [](size_t i, const Chunk & c) { return i < c.Base; }) -
+                 1);
+    }
+
+    inline value_t & operator[](const size_t I)
+    {
+        const Chunk & chunk{chunkOf(I)};
+        return const_cast<Chunk &>(chunk).Data[I - chunk.Base];
+    }
+
+    inline const value_t & operator[](const size_t I) const
+    {
+        const Chunk & chunk{chunkOf(I)};
+        return chunk.Data[I - chunk.Base];
+    }
+
+    void emplace_back(const value_t & value)
+    {
+        if (_chunks.empty() || _chunks.back().Sealed) _chunks.emplace_back(Chunk{{}, _size});
+        _chunks.back().Data.emplace_back(value);
+        _size++;
+    }
+
+    /**
+     * @brief Appends data as a new (sealed) chunk without copying its elements.
+     */
+    void adopt(std::vector<value_t> && data, const meta_t & meta)
+    {
+        if (data.empty()) return;
+        const size_t SIZE{data.size()};
+        _chunks.emplace_back(Chunk{std::move(data), _size, meta, true});
+        _size += SIZE;
+    }
+
+    /**
+     * @brief Replaces the content by a single chunk.
+     */
+    void assign(std::vector<value_t> && data)
+    {
+        _chunks.clear();
+        _size = data.size();
+        if (_size) _chunks.emplace_back(Chunk{std::move(data), 0});
+    }
+};
+
+} // namespace imp
+
+namespace imp::json
+{
+
+template <typename value_t, typename meta_t>
+inline std::string __makeJSON(const imp::ChunkedVector<value_t, meta_t> * v)
+{
+    std::stringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < v->size(); ++i)
+    {
+        auto & val = v->operator[](i);
+        JSONP(val)
+        if (i != v->size() - 1) ss << ",";
+    }
+    ss << "]";
+    return ss.str();
+}
+
+} // namespace imp::json
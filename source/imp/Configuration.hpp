@@ -1,6 +1,7 @@
 #pragma once
 
 #include <numbers>
+#include <type_traits>
 
 #include "fcl/fcl.h"
 #include "imp/json/JSON.hpp"
@@ -8,6 +9,35 @@
 namespace imp
 {
 
+struct Configuration;
+
+/**
+ * @brief Trivially copyable storage of a configuration for bulk node data. The layout matches
+ * the indexing of Configuration (position x, y, z followed by rotation w, x, y, z).
+ */
+struct Pose
+{
+    /////////
+    // data
+    /////////
+public:
+    float Data[7]{0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f};
+
+    /////////
+    // constructors
+    /////////
+public:
+    Pose() = default;
+    Pose(const Configuration & c);
+
+    /////////
+    // properties
+    /////////
+public:
+    inline float & operator[](const size_t & i) { return Data[i]; }
+    inline float operator[](const size_t & i) const { return Data[i]; }
+};
+
 /**
  * @brief Struct representing a motion planning configuration in 3D-Space.
  *
@@ -38,6 +68,9 @@ public:
     Configuration(const fcl::Vector3f & position, const fcl::Quaternionf & rotation)
         : Position{position}, Rotation{rotation}
     {}
+    Configuration(const Pose & pose)
+        : Position{pose[0], pose[1], pose[2]}, Rotation{pose[3], pose[4], pose[5], pose[6]}
+    {}
     /////////
     // properties
     /////////
@@ -59,6 +92,12 @@ public:
     float operator[](const size_t & i) const { return (*const_cast<Configuration *>(this))[i]; }
 };
 
+inline Pose::Pose(const Configuration & c)
+    : Data{c[0], c[1], c[2], c[3], c[4], c[5], c[6]}
+{}
+
+static_assert(std::is_trivially_copyable_v<Pose>);
+
 using DistancePair = std::pair<float, float>;
 float Distance(const imp::Configuration & a, const Configuration & b);
 float PDistance(const Configuration & a, const Configuration & b);
@@ -66,4 +105,14 @@ float RDistance(const Configuration & a, const Configuration & b);
 float Distance(const Configuration & a, const Configuration & b, float rotation_scale);
 DistancePair PairDistance(const Configuration & a, const Configuration & b);
 
-} // namespace imp
\ No newline at end of file
+} // namespace imp
+
+namespace imp::json
+{
+
+template <> inline std::string __makeJSON(const imp::Pose * v)
+{
+    return imp::Configuration(*v).toJSON();
+}
+
+} // namespace imp::json
\ No newline at end of file
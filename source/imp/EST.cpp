@@ -1,5 +1,11 @@
 #include "imp/EST.hpp"
 
+#include <omp.h>
+
+#include "imp/io/ESTDumper.hpp"
+#include "imp/metrics/Metrics.hpp"
+#include "imp/time/Tracer.hpp"
+
 std::vector<size_t> imp::EST::kSmallest(const size_t K)
 {
     std::partial_sort(                                  //
@@ -15,6 +21,53 @@ std::vector<size_t> imp::EST::kSmallest(const size_t K)
     return result;
 }
 
+size_t imp::EST::batchSize(const size_t WORKERS, const time::duration_t & REMAINING) const
+{
+    // number of candidates expected to yield the targeted number of new nodes
+    const float RATE{std::max(_batching.AcceptanceRate, EST_MIN_ACCEPTANCE_RATE)};
+    size_t size{static_cast<size_t>(
+        std::ceil(static_cast<float>(WORKERS * EST_TARGET_NEW_NODES_PER_WORKER) / RATE))};
+
+    // do not plan more work than fits into the remaining runtime
+    if (_batching.CandidateSeconds > 0.0f)
+    {
+        const float SECONDS{std::chrono::duration<float>(REMAINING).count()};
+        size = std::min(size, static_cast<size_t>(std::max(SECONDS, 0.0f) /
+                                                  _batching.CandidateSeconds * WORKERS));
+    }
+
+    // full rounds of workers only
+    size = math::sdiv(size, WORKERS) * WORKERS;
+    return std::clamp(size, WORKERS, std::max(WORKERS, EST_MAX_NEW_SAMPLES));
+}
+
+void imp::EST::updateBatching(const size_t WORKERS, const size_t CANDIDATES, const size_t ACCEPTED,
+                              const time::duration_t & DURATION)
+{
+    if (!CANDIDATES) return;
+
+    const float RATE{static_cast<float>(ACCEPTED) / CANDIDATES};
+    const float CANDIDATE_SECONDS{std::chrono::duration<float>(DURATION).count() * WORKERS /
+                                  CANDIDATES};
+
+    _batching.AcceptanceRate = (1.0f - EST_ACCEPTANCE_SMOOTHING) * _batching.AcceptanceRate +
+                               EST_ACCEPTANCE_SMOOTHING * RATE;
+
+    // timings must not influence deterministic explorations
+    if (!_seed.has_value())
+    {
+        _batching.CandidateSeconds =
+            _batching.CandidateSeconds > 0.0f
+                ? (1.0f - EST_ACCEPTANCE_SMOOTHING) * _batching.CandidateSeconds +
+                      EST_ACCEPTANCE_SMOOTHING * CANDIDATE_SECONDS
+                : CANDIDATE_SECONDS;
+    }
+
+    _statistics.Iterations++;
+    _statistics.Candidates += CANDIDATES;
+    _statistics.Accepted += ACCEPTED;
+}
+
 void imp::EST::emplaceBack(const ESTNode & config)
 {
     _nodes.emplace_back(config);
@@ -25,12 +78,8 @@ std::vector<imp::Configuration> imp::EST::construct(size_t node_index)
 {
     std::vector<Configuration> result;
 
-    auto node = _nodes[node_index];
-    while (!node.IsRoot)
-    {
-        result.emplace_back(node.Config);
-        node = _nodes[node.Parent];
-    }
+    for (const ESTNode * node = &_nodes[node_index]; !node->isRoot(); node = &_nodes[node->Parent])
+        result.emplace_back(node->Config);
 
     std::reverse(result.begin(), result.end());
     return result;
@@ -38,25 +87,46 @@ std::vector<imp::Configuration> imp::EST::construct(size_t node_index)
 
 std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
     const Configuration & ROOT,                                        //
-    std::pair<size_t, Configuration> MATCHEE,                          //
-    bool collision_free_matchee)
+    const std::vector<std::pair<size_t, Configuration>> & MATCHEES,    //
+    bool collision_free_matchee,                                       //
+    const time::duration_t & RUNTIME,                                  //
+    const CancellationToken * cancellation)
 {
     // clean all nodes in tree
     clear();
     std::lock_guard<std::mutex> guard(_explore_mutex);
+    CancellationLink link(_cancellation, cancellation); // the caller's token may die on return
+    _scene_version = _manager.sceneVersion(); // later static objects are checked on join
+
+    metrics::add(metrics::Counter::Explorations);
+    metrics::ScopedTimer explore_timer(metrics::Histogram::Explore);
+    time::Span explore_span("est.explore");
+    time::Span phase("est.setup"); // consecutive phases, see Span::next
+
+    if (MATCHEES.empty()) return std::make_pair(-1, std::vector<Configuration>());
+
+    const float BOUNDING{_manager.bounding(_MOVABLE_ID)};
+
+    // the first matchee is the primary one, the center is placed towards all of them
+    fcl::Vector3f matchees_centroid{fcl::Vector3f::Zero()};
+    for (const auto & matchee : MATCHEES) matchees_centroid += matchee.second.Position;
+    matchees_centroid /= static_cast<float>(MATCHEES.size());
 
     const Configuration CENTER{
-        imp::math::lerp(ROOT.Position, MATCHEE.second.Position, 0.5f),
-        imp::math::lerp(ROOT.Rotation, MATCHEE.second.Rotation, 0.5f),
+        imp::math::lerp(ROOT.Position, matchees_centroid, 0.5f),
+        imp::math::lerp(ROOT.Rotation, MATCHEES.front().second.Rotation, 0.5f),
     };
 
     // compute sampling area
     float max_rot_distance{EST_DOMAIN_INITIAL_ROTATION_LIMIT};
     float max_pos_distance{PDistance(CENTER, ROOT) * EST_DOMAIN_GROW_FACTOR};
 
+    float matchees_extent{PDistance(CENTER, ROOT)};
+    for (const auto & matchee : MATCHEES)
+        matchees_extent = std::max(matchees_extent, PDistance(CENTER, matchee.second));
+
     const float TOTAL_MAX_ROT_DISTANCE{std::numbers::pi_v<float>};
-    const float TOTAL_MAX_POS_DISTANCE{(CENTER.Position - ROOT.Position).norm() +
-                                       _manager.bounding(_MOVABLE_ID) / 2.0f};
+    const float TOTAL_MAX_POS_DISTANCE{matchees_extent + BOUNDING / 2.0f};
 
     CKDTreeBox domain;
     for (size_t i = 0; i < 3; ++i)
@@ -74,7 +144,7 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
     ESTNode root_node;
     root_node.Config = ROOT;
     root_node.Rating = 0;
-    root_node.IsRoot = true;
+    root_node.Parent = ESTNode::NO_PARENT;
     emplaceBack(root_node);
 
     // setup kd-tree
@@ -82,18 +152,62 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
         _nodes, domain,
         std::make_pair(EST_POSITIONAL_CLUSTER_DISTANCE, EST_ROTATIONAL_CLUSTER_DISTANCE));
 
+    // spatial index over the matchees, a match requires both distances to be below the limits
+    std::vector<CKDData> matchee_data;
+    CKDTreeBox matchee_domain;
+    for (const auto & matchee : MATCHEES)
+    {
+        matchee_data.emplace_back(matchee.second);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            matchee_domain.Min[i] =
+                std::min(matchee_domain.Min[i], matchee.second[i] - EST_MIN_MATCHEE_DISTANCE);
+            matchee_domain.Max[i] =
+                std::max(matchee_domain.Max[i], matchee.second[i] + EST_MIN_MATCHEE_DISTANCE);
+        }
+    }
+    for (size_t i = 3; i < 7; ++i)
+    {
+        matchee_domain.Min[i] = -1.0f;
+        matchee_domain.Max[i] = 1.0f;
+    }
+    const DistancePair MATCHEE_DISTANCES{EST_MIN_MATCHEE_DISTANCE,
+                                         EST_MIN_MATCHEE_DISTANCE / BOUNDING};
+    CKDTree<CKDData> matchee_index(matchee_data, matchee_domain, MATCHEE_DISTANCES);
+
     std::optional<size_t> solution;
+    std::optional<size_t> solution_matchee;
     std::mutex solution_lock;
 
 #define __IMP_EST_EXECUTION_FAIL                                                                   \
-    if (!_execution_allowed) return std::make_pair(-1, std::vector<Configuration>());
+    if (_cancellation.cancelled()) return std::make_pair(-1, std::vector<Configuration>());
+
+    // the deterministic mode must not depend on the machine
+    const bool DETERMINISTIC{_seed.has_value()};
+    const size_t WORKERS{DETERMINISTIC
+                             ? EST_DETERMINISTIC_WORKERS
+                             : static_cast<size_t>(std::max(omp_get_max_threads(), 1))};
+    if (DETERMINISTIC) _batching = ESTBatching();
+    _statistics = ESTStatistics();
+    {
+        std::lock_guard<std::mutex> progress_guard(_progress_mutex);
+        _progress = ESTProgress();
+        _progress.Exploration = _exploration_counter;
+    }
+
+    // the workers of the parallel regions attribute their spans to the caller's request
+    const int64_t TRACE_REQUEST{time::request()};
 
     time::Timer timer;
     size_t steps{0};
-    while (_execution_allowed && timer.elapsed() < EST_MAX_EXPLORATION_RUNTIME &&
-           _nodes.size() < EST_MAX_SIZE)
+    while (!_cancellation.cancelled() && _nodes.size() < EST_MAX_SIZE &&
+           (DETERMINISTIC ? steps < EST_DETERMINISTIC_MAX_STEPS
+                          : timer.elapsed() < RUNTIME))
     {
-        std::vector<ESTNodeCandidate> candidates(std::min(_nodes.size(), EST_MAX_NEW_SAMPLES));
+        time::Timer step_timer;
+        phase.next("est.k-smallest");
+        std::vector<ESTNodeCandidate> candidates(
+            batchSize(WORKERS, RUNTIME - timer.elapsed()));
 
         if (steps % EST_DOMAIN_ROTATION_INCREASE_STEP == 0)
         {
@@ -110,22 +224,30 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
         }
 
         steps++;
+        metrics::add(metrics::Counter::ESTIterations);
 
-        // get the first k nodes with the smallest rating
-        auto k_smallest = kSmallest(candidates.size());
+        // get the first k nodes with the smallest rating, large batches expand them repeatedly
+        auto k_smallest = kSmallest(std::min(candidates.size(), _nodes.size()));
 
         // sample new local configurations
+        phase.next("est.sample");
 #pragma omp parallel for
         for (int64_t i = 0; i < candidates.size(); ++i)
         {
             auto & candidate = candidates[i];
-            candidate.Parent = k_smallest[i];
-            candidate.Start = _nodes[k_smallest[i]].Config;
+            candidate.Parent = k_smallest[i % k_smallest.size()];
+            candidate.Start = _nodes[candidate.Parent].Config;
+
+            // one random stream per (step, candidate) in deterministic mode
+            std::optional<random::_implementation::Sampler> stream;
+            if (DETERMINISTIC)
+                stream = random::Sampler(_seed.value(), (steps << 32) | static_cast<uint64_t>(i));
+            auto & sampler{DETERMINISTIC ? stream.value() : random::Sampler()};
 
-            if (random::Sampler().rand() < EST_BIASED_SAMPLE_PROPABILITY)
+            if (sampler.rand() < EST_BIASED_SAMPLE_PROPABILITY)
             {
-                candidate.End = random::Sampler().randConfigurationArroundMinimumDistance(
-                    _nodes[k_smallest[i]].Config,        // config to sample arroung
+                candidate.End = sampler.randConfigurationArroundMinimumDistance(
+                    candidate.Start,                     // config to sample arroung
                     EST_SAMPLE_MAX_POSITIONAL_DISTANCE,  // maximum positional distance
                     EST_SAMPLE_MAX_ROTATIONAL_DISTANCE,  // maximum rotational distance
                     EST_SAMPLE_MIN_POSITIONAL_DISTANCE,  // minimum positional distance
@@ -133,8 +255,14 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
             }
             else
             {
-                Configuration change{random::Sampler().randTargetConfigurationChange(
-                    candidate.Start, MATCHEE.second)};
+                const auto & target{
+                    MATCHEES.size() > 1
+                        ? MATCHEES[std::min(static_cast<size_t>(sampler.rand() * MATCHEES.size()),
+                                            MATCHEES.size() - 1)]
+                        : MATCHEES.front()};
+
+                Configuration change{
+                    sampler.randTargetConfigurationChange(candidate.Start, target.second)};
 
                 candidate.End = {candidate.Start.Position + change.Position,
                                  candidate.Start.Rotation * change.Rotation};
@@ -142,12 +270,17 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
             candidate.Rating = 0;
         }
 
+        metrics::observe(metrics::Histogram::ESTSample, step_timer.elapsed());
+        time::Timer phase_timer;
+
         __IMP_EST_EXECUTION_FAIL
 
-// check which are collision free
+        // check which are collision free
+        phase.next("est.validate");
 #pragma omp parallel for
         for (int64_t i = 0; i < candidates.size(); ++i)
         {
+            time::TraceScope scope(TRACE_REQUEST);
             if (PDistance(candidates[i].End, CENTER) > max_pos_distance ||
                 RDistance(candidates[i].End, CENTER) > max_rot_distance)
             {
@@ -157,13 +290,19 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
             {
                 candidates[i].Valid = _manager.isCollisionFreePath(_MOVABLE_ID,         //
                                                                    candidates[i].Start, //
-                                                                   candidates[i].End);
+                                                                   candidates[i].End,   //
+                                                                   &_cancellation);
             }
         }
 
+        metrics::observe(metrics::Histogram::ESTValidate, phase_timer.elapsed());
+        phase_timer = time::Timer();
+
         __IMP_EST_EXECUTION_FAIL
 
         // remove invalid candidates
+        phase.next("est.filter");
+        const size_t NUM_CANDIDATES{candidates.size()};
         std::vector<ESTNodeCandidate> candidates_buffer;
         for (size_t i = 0; i < candidates.size(); ++i)
         {
@@ -171,43 +310,88 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
         }
         std::swap(candidates, candidates_buffer);
 
+        updateBatching(WORKERS, NUM_CANDIDATES, candidates.size(), step_timer.elapsed());
+
         __IMP_EST_EXECUTION_FAIL
 
         // keep the previous size
         const size_t PREVIOUS_SIZE{_nodes.size()};
 
         // insert into tree
+        phase.next("est.insert");
         for (size_t i = 0; i < candidates.size(); ++i)
         {
             auto & candidate = candidates[i];
 
             ESTNode node;
             node.Config = candidate.End;
-            node.Parent = candidate.Parent;
-            node.Rating = candidate.Rating;
+            node.Parent = static_cast<uint32_t>(candidate.Parent);
+            node.Rating = static_cast<uint32_t>(candidate.Rating);
 
             emplaceBack(node);
         }
+        phase.next("est.revalidate");
         kdtree.revalidate(); // ranking is updated here !
+        metrics::add(metrics::Counter::ESTNodes, candidates.size());
+
+        // publish the progress of this step
+        phase.next("est.progress");
+        {
+            std::optional<size_t> best;
+            float best_distance{std::numeric_limits<float>::max()};
+            for (size_t i = 0; i < candidates.size(); ++i)
+            {
+                if (float dst = Distance(MATCHEES.front().second, candidates[i].End, BOUNDING);
+                    dst < best_distance)
+                {
+                    best_distance = dst;
+                    best = i;
+                }
+            }
+
+            std::lock_guard<std::mutex> progress_guard(_progress_mutex);
+            _progress.Iterations = steps;
+            _progress.Nodes = _nodes.size();
+            if (best.has_value() && (!_progress.Best.has_value() ||
+                                     best_distance < _progress.BestDistance))
+            {
+                _progress.BestDistance = best_distance;
+                _progress.Best = candidates[best.value()].End;
+            }
+        }
+
+        metrics::observe(metrics::Histogram::ESTInsert, phase_timer.elapsed());
+        phase_timer = time::Timer();
 
         __IMP_EST_EXECUTION_FAIL
 
         // check if we match any target
-
+        phase.next("est.match");
         if (collision_free_matchee)
         {
 #pragma omp parallel for
             for (int64_t i = 0; i < candidates.size(); ++i)
             {
+                time::TraceScope scope(TRACE_REQUEST);
                 auto & candidate = candidates[i];
-                if (Distance(MATCHEE.second, candidate.End, _manager.bounding(_MOVABLE_ID)) <
-                    EST_MIN_MATCHEE_DISTANCE)
+                for (size_t m : matchee_index.within(candidate.End, MATCHEE_DISTANCES))
                 {
-                    if (_manager.isCollisionFreePath(_MOVABLE_ID, MATCHEE.second, candidate.End))
+                    const auto & matchee{MATCHEES[m].second};
+                    if (Distance(matchee, candidate.End, BOUNDING) >= EST_MIN_MATCHEE_DISTANCE)
+                        continue;
+                    if (!_manager.isCollisionFreePath(_MOVABLE_ID, matchee, candidate.End,
+                                                      &_cancellation))
+                        continue;
+
+                    // first match wins independent of the thread scheduling
+                    std::lock_guard<std::mutex> solution_guard(solution_lock);
+                    if (!solution.has_value() || i + PREVIOUS_SIZE < solution.value() ||
+                        (i + PREVIOUS_SIZE == solution.value() && m < solution_matchee.value()))
                     {
-                        std::lock_guard<std::mutex> solution_guard(solution_lock);
                         solution = i + PREVIOUS_SIZE;
+                        solution_matchee = m;
                     }
+                    break;
                 }
             }
         }
@@ -216,32 +400,66 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
             for (int64_t i = 0; i < candidates.size(); ++i)
             {
                 auto & candidate = candidates[i];
-                if (Distance(MATCHEE.second, candidate.End) < EST_MIN_MATCHEE_DISTANCE / 2.0f)
+                if (Distance(MATCHEES.front().second, candidate.End) <
+                    EST_MIN_MATCHEE_DISTANCE / 2.0f)
                 {
                     break;
                 }
             }
         }
 
+        metrics::observe(metrics::Histogram::ESTMatch, phase_timer.elapsed());
         if (solution.has_value()) break;
     }
 
     __IMP_EST_EXECUTION_FAIL
 
+    _statistics.Seconds = std::chrono::duration<float>(timer.elapsed()).count();
+    _statistics.NodesPerSecond =
+        _statistics.Seconds > 0.0f ? (_nodes.size() - 1) / _statistics.Seconds : 0.0f;
+
     // prepare data for client
-    size_t matchee_index = MATCHEE.first;
+    phase.next("est.solution");
     bool complete_solution = solution.has_value();
-    if (!solution.has_value())
+    if (complete_solution)
+    {
+        // the (validated) connection to the matchee completes the path
+        ESTNode matchee_node;
+        matchee_node.Config = MATCHEES[solution_matchee.value()].second;
+        matchee_node.Parent = static_cast<uint32_t>(solution.value());
+        emplaceBack(matchee_node);
+        solution = _nodes.size() - 1;
+    }
+    else
     {
         float best_distance = std::numeric_limits<float>::max();
-        for (size_t i = 0; i < _nodes.size(); ++i)
+#pragma omp parallel
         {
-            if (float dst =
-                    Distance(MATCHEE.second, _nodes[i].Config, _manager.bounding(_MOVABLE_ID));
-                dst < best_distance)
+            float local_best_distance = std::numeric_limits<float>::max();
+            size_t local_solution{0};
+
+#pragma omp for nowait
+            for (int64_t i = 0; i < _nodes.size(); ++i)
             {
-                best_distance = dst;
-                solution = i;
+                const Configuration NODE{_nodes[i].Config};
+                for (const auto & matchee : MATCHEES)
+                {
+                    if (float dst = Distance(matchee.second, NODE, BOUNDING);
+                        dst < local_best_distance)
+                    {
+                        local_best_distance = dst;
+                        local_solution = i;
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> solution_guard(solution_lock);
+            if (local_best_distance < best_distance ||
+                (solution.has_value() && local_best_distance == best_distance &&
+                 local_solution < solution.value()))
+            {
+                best_distance = local_best_distance;
+                solution = local_solution;
             }
         }
     }
@@ -250,13 +468,34 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
 
     _last_solution = solution.value();
 
-// #ifdef DUMP_REQUESTS
+    // sampled binary dump, written in the background (no writer thread if dumps are off)
+    phase.next("est.dump");
+    if constexpr (EST_DUMP_SAMPLING_INTERVAL != 0)
+    {
+        if (auto & dumper{io::ESTDumper::get()}; dumper.sample())
+        {
+            io::ESTDump dump;
+            dump.Session = _session_id;
+            dump.Exploration = _exploration_counter;
+            dump.Matchee = MATCHEES[solution_matchee.value_or(0)].second;
+            dump.SolutionIndex = static_cast<uint32_t>(solution.value());
+            dump.CompleteSolution = complete_solution;
+            dump.Statistics = _statistics;
+            dump.Nodes = _nodes;
+            dump.Objects = _manager.staticObjects();
+            dumper.push(std::move(dump));
+        }
+    }
+
+#ifdef DUMP_REQUESTS
+    phase.next("est.dump-json");
     {
-        auto & Matchee{MATCHEE.second};
+        auto & Matchee{MATCHEES[solution_matchee.value_or(0)].second};
         auto & CompleteSolution{complete_solution};
         auto & SolutionIndex{solution.value()};
         auto & Objects{_manager};
         auto & KDTree{kdtree};
+        auto & Statistics{_statistics};
 
         // construct filename
         std::stringstream fn;
@@ -271,23 +510,21 @@ std::pair<int64_t, std::vector<imp::Configuration>> imp::EST::explore( //
         JSOND(KDTree)
         JSOND(SolutionIndex)
         JSOND(CompleteSolution)
+        JSOND(Statistics)
         JSON(Objects)
         ss << "}";
 
         ss.close();
     }
-// #endif
+#endif
 
 #undef __IMP_EST_EXECUTION_FAIL
 
-    // if (complete_solution)
-    // {
-    //     auto path = construct(solution.value());
-    //     path.emplace_back(MATCHEE.second);
-    //     return std::make_pair(matchee_index, path);
-    // }
-    // else
-    // {
+    phase.next("est.construct");
+    if (complete_solution)
+    {
+        return std::make_pair(static_cast<int64_t>(MATCHEES[solution_matchee.value()].first),
+                              construct(solution.value()));
+    }
     return std::make_pair(-1, construct(solution.value()));
-    // }
 }
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "imp/CKDTree.hpp"
+#include "imp/Cancellation.hpp"
 #include "imp/Configuration.hpp"
 #include "imp/ObjectManager.hpp"
 #include "imp/Settings.hpp"
@@ -21,6 +22,47 @@ using namespace std::chrono_literals;
 
 class WorldTree;
 
+/**
+ * @brief Runtime statistics of the last exploration.
+ */
+struct ESTStatistics : public json::JSONable
+{
+    JSON_IMPL(                  //
+        JSOND(Iterations)       //
+        JSOND(Candidates)       //
+        JSOND(Accepted)         //
+        JSOND(Seconds)          //
+        JSON(NodesPerSecond)    //
+    )
+
+    size_t Iterations{0};
+    size_t Candidates{0};
+    size_t Accepted{0};
+    float Seconds{0.0f};
+    float NodesPerSecond{0.0f};
+};
+
+/**
+ * @brief Snapshot of a running exploration, published after every step. Best is the node
+ * closest to the primary matchee so far.
+ */
+struct ESTProgress : public json::JSONable
+{
+    JSON_IMPL(                  //
+        JSOND(Exploration)      //
+        JSOND(Iterations)       //
+        JSOND(Nodes)            //
+        JSOND(BestDistance)     //
+        JSON(Best)              //
+    )
+
+    size_t Exploration{0};
+    size_t Iterations{0};
+    size_t Nodes{0};
+    float BestDistance{0.0f};
+    std::optional<Configuration> Best;
+};
+
 /**
  * @brief Representing an exploring space tree.
  *
@@ -48,6 +90,16 @@ protected:
         float Rating{0};
     };
 
+    /**
+     * @brief Observed quantities the batch size of an exploration step is derived from. These
+     * are kept between explorations as subsequent queries usually happen in similar regions.
+     */
+    struct ESTBatching
+    {
+        float AcceptanceRate{1.0f};   // smoothed fraction of valid candidates
+        float CandidateSeconds{0.0f}; // smoothed worker seconds spent per candidate
+    };
+
     /////////
     // data
     /////////
@@ -60,8 +112,18 @@ private:
     std::vector<size_t> _sorted_indices;
     ObjectManager & _manager;
     const size_t _MOVABLE_ID;
-    bool _execution_allowed = true;
+    CancellationToken _cancellation; // linked to the caller's token while exploring
     size_t _last_solution = -1;
+    uint64_t _scene_version{0}; // of the scene the nodes were validated against
+
+    ESTBatching _batching;
+    ESTStatistics _statistics;
+
+    mutable std::mutex _progress_mutex;
+    ESTProgress _progress;
+
+    // seed of the deterministic mode
+    std::optional<uint64_t> _seed;
 
     /////////
     // constructors
@@ -72,13 +134,48 @@ public:
               std::chrono::time_point_cast<std::chrono::seconds>(std::chrono::system_clock::now())
                   .time_since_epoch()
                   .count())},
-          _manager{manager}, _MOVABLE_ID{MOVABLE_ID} {};
+          _manager{manager}, _MOVABLE_ID{MOVABLE_ID}
+    {
+#ifdef DETERMINISTIC_EST
+        _seed = EST_DETERMINISTIC_SEED;
+#endif
+    };
 
     /////////
     // methods
     /////////
 public:
-    inline void stop() { _execution_allowed = false; }
+    /**
+     * @brief Cancels the running exploration, it returns at its next checkpoint (at the latest
+     * after a single path validation step).
+     */
+    inline void stop() { _cancellation.cancel(); }
+
+    /**
+     * @brief Statistics of the last finished exploration.
+     */
+    inline const ESTStatistics & statistics() const { return _statistics; }
+
+    /**
+     * @brief Progress of the running (or last) exploration, safe to call while exploring.
+     */
+    inline ESTProgress progress() const
+    {
+        std::lock_guard<std::mutex> guard(_progress_mutex);
+        return _progress;
+    }
+
+    /**
+     * @brief Enables the deterministic mode for the given seed (or disables it for std::nullopt).
+     * Each candidate then draws from its own counter-based random stream and the batch size
+     * and termination no longer depend on the thread count or wall-clock time, so a seed and
+     * scene always yield the identical tree.
+     */
+    inline void seed(std::optional<uint64_t> seed)
+    {
+        std::lock_guard<std::mutex> guard(_explore_mutex);
+        _seed = seed;
+    }
 
     /////////
     // methods
@@ -86,6 +183,18 @@ public:
 private:
     std::vector<size_t> kSmallest(const size_t K);
 
+    /**
+     * @brief Number of candidates to sample in the next step, derived from the observed
+     * acceptance rate, the number of workers and the remaining runtime.
+     */
+    size_t batchSize(const size_t WORKERS, const time::duration_t & REMAINING) const;
+
+    /**
+     * @brief Feeds the outcome of a step back into the batch size estimation.
+     */
+    void updateBatching(const size_t WORKERS, const size_t CANDIDATES, const size_t ACCEPTED,
+                        const time::duration_t & DURATION);
+
     void emplaceBack(const ESTNode & config);
 
 public:
@@ -97,7 +206,7 @@ public:
         std::lock_guard<std::mutex> guard(_explore_mutex);
         _nodes.clear();
         _sorted_indices.clear();
-        _execution_allowed = true;
+        _cancellation.reset();
         _exploration_counter++;
     }
 
@@ -108,11 +217,19 @@ public:
 
     /**
      * @brief Explore arround the given ROOT configuration and try to match any
-     * of the given matchees.
+     * of the given matchees (index, configuration). The first matchee is the primary one.
+     *
+     * @param RUNTIME Exploration budget (ignored in the deterministic mode).
+     * @param cancellation Optional token of the caller, cancels like stop().
+     * @return The index of the reached matchee (-1 if none was reached) and the path to it, or
+     * to the node closest to any matchee.
      */
-    std::pair<int64_t, std::vector<Configuration>> explore( //
-        const Configuration & ROOT,                         //
-        std::pair<size_t, Configuration> MATCHEE, bool collision_free_matchee = true);
+    std::pair<int64_t, std::vector<Configuration>> explore(                //
+        const Configuration & ROOT,                                        //
+        const std::vector<std::pair<size_t, Configuration>> & MATCHEES,    //
+        bool collision_free_matchee = true,                                //
+        const time::duration_t & RUNTIME = EST_MAX_EXPLORATION_RUNTIME,    //
+        const CancellationToken * cancellation = nullptr);
 };
 
 } // namespace imp
@@ -1,22 +1,47 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
 #include "imp/CKDTree.hpp"
 #include "json/JSON.hpp"
 
 namespace imp
 {
 
+/**
+ * @brief Node of an EST or WorldTree. Trivially copyable (pose, rating and parent in 36 bytes),
+ * the JSON export lives in imp::json::__makeJSON.
+ */
 struct ESTNode : public CKDData
 {
-    JSON_IMPL(        //
-        JSOND(Config) //
-        JSOND(Rating) //
-        JSOND(Parent) //
-        JSON(IsRoot)  //
-    )
-
-    size_t Parent{0};
-    bool IsRoot{false};
+    static constexpr uint32_t NO_PARENT{std::numeric_limits<uint32_t>::max()};
+
+    uint32_t Parent{NO_PARENT};
+
+    inline bool isRoot() const { return Parent == NO_PARENT; }
 };
 
+static_assert(std::is_trivially_copyable_v<ESTNode>);
+
 }
+
+namespace imp::json
+{
+
+template <> inline std::string __makeJSON(const imp::ESTNode * v)
+{
+    const bool IsRoot{v->isRoot()};
+
+    std::stringstream ss;
+    ss << "{";
+    JSONND(Config, v->Config)
+    JSONND(Rating, v->Rating)
+    JSONND(Parent, v->Parent)
+    JSON(IsRoot)
+    ss << "}";
+    return ss.str();
+}
+
+} // namespace imp::json
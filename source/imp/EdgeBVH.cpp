@@ -0,0 +1,72 @@
+#include "imp/EdgeBVH.hpp"
+
+#include <algorithm>
+
+void imp::EdgeBVH::build(std::vector<std::pair<uint32_t, fcl::AABBf>> && edges)
+{
+    _edges = std::move(edges);
+    _nodes.clear();
+    _nodes.reserve(2 * (_edges.size() / LEAF_SIZE + 1));
+    if (!_edges.empty()) build(0, static_cast<uint32_t>(_edges.size()));
+}
+
+uint32_t imp::EdgeBVH::build(uint32_t begin, uint32_t end)
+{
+    const uint32_t INDEX{static_cast<uint32_t>(_nodes.size())};
+    _nodes.emplace_back();
+
+    fcl::AABBf box{_edges[begin].second};
+    for (uint32_t i = begin + 1; i < end; ++i) box += _edges[i].second;
+    _nodes[INDEX].Box = box;
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        _nodes[INDEX].Begin = begin;
+        _nodes[INDEX].End = end;
+        return INDEX;
+    }
+
+    // median split along the longest axis of the node box
+    const fcl::Vector3f EXTENT{box.max_ - box.min_};
+    int axis{0};
+    EXTENT.maxCoeff(&axis);
+
+    const uint32_t MIDDLE{begin + (end - begin) / 2};
+    std::nth_element(_edges.begin() + begin, _edges.begin() + MIDDLE, _edges.begin() + end,
+                     [axis](const auto & a, const auto & b) {
+                         return a.second.min_[axis] + a.second.max_[axis] <
+                                b.second.min_[axis] + b.second.max_[axis];
+                     });
+
+    const uint32_t LEFT{build(begin, MIDDLE)};
+    const uint32_t RIGHT{build(MIDDLE, end)};
+    _nodes[INDEX].Left = LEFT;
+    _nodes[INDEX].Right = RIGHT;
+    return INDEX;
+}
+
+std::vector<uint32_t> imp::EdgeBVH::overlapping(const fcl::AABBf & box) const
+{
+    std::vector<uint32_t> result;
+    if (_nodes.empty()) return result;
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty())
+    {
+        const Node & node{_nodes[stack.back()]};
+        stack.pop_back();
+
+        if (!node.Box.overlap(box)) continue;
+        if (node.Left == NONE)
+        {
+            for (uint32_t i = node.Begin; i < node.End; ++i)
+                if (_edges[i].second.overlap(box)) result.emplace_back(_edges[i].first);
+        }
+        else
+        {
+            stack.emplace_back(node.Left);
+            stack.emplace_back(node.Right);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <fcl/fcl.h>
+
+namespace imp
+{
+
+/**
+ * @brief Bounding volume hierarchy over axis aligned boxes of graph edges (e.g. the swept
+ * volume of a movable along a WorldTree edge). Built in bulk, answers overlap queries.
+ */
+class EdgeBVH
+{
+    /////////
+    // nested
+    /////////
+private:
+    static constexpr uint32_t NONE{UINT32_MAX};
+    static constexpr size_t LEAF_SIZE{8};
+
+    struct Node
+    {
+        fcl::AABBf Box;
+        uint32_t Left{NONE}; // leaves store the range [Begin, End) of _edges
+        uint32_t Right{NONE};
+        uint32_t Begin{0};
+        uint32_t End{0};
+    };
+
+    /////////
+    // data
+    /////////
+private:
+    std::vector<Node> _nodes;
+    std::vector<std::pair<uint32_t, fcl::AABBf>> _edges;
+
+    /////////
+    // properties
+    /////////
+public:
+    inline size_t size() const noexcept { return _edges.size(); }
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Replaces the hierarchy by one over the given (edge id, box) pairs.
+     */
+    void build(std::vector<std::pair<uint32_t, fcl::AABBf>> && edges);
+
+    /**
+     * @brief Ids of all edges whose box overlaps the given box.
+     */
+    std::vector<uint32_t> overlapping(const fcl::AABBf & box) const;
+
+private:
+    uint32_t build(uint32_t begin, uint32_t end);
+};
+
+} // namespace imp
@@ -0,0 +1,107 @@
+#include "imp/MeshRegistry.hpp"
+
+#include <cstring>
+
+#include "imp/metrics/Metrics.hpp"
+
+std::shared_ptr<imp::MeshRegistry::Model>
+imp::MeshRegistry::acquire(const std::vector<fcl::Vector3f> & vertices,
+                           const std::vector<fcl::Triangle> & triangles)
+{
+    const uint64_t HASH{hash(vertices, triangles)};
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (auto model = find(HASH, vertices, triangles))
+        {
+            metrics::add(metrics::Counter::MeshCacheHits);
+            return model;
+        }
+    }
+    metrics::add(metrics::Counter::MeshCacheMisses);
+
+    // building dominates, concurrent uploads of distinct meshes must not serialize here
+    auto model = std::make_shared<Model>();
+    model->beginModel();
+    model->addSubModel(vertices, triangles);
+    model->endModel();
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (auto registered = find(HASH, vertices, triangles)) return registered; // lost the race
+    _models.emplace(HASH, model);
+    return model;
+}
+
+size_t imp::MeshRegistry::size()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    size_t live{0};
+    for (const auto & [hash, model] : _models) live += !model.expired();
+    return live;
+}
+
+void imp::MeshRegistry::purge()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    std::erase_if(_models, [](const auto & entry) { return entry.second.expired(); });
+}
+
+uint64_t imp::MeshRegistry::hash(const std::vector<fcl::Vector3f> & vertices,
+                                 const std::vector<fcl::Triangle> & triangles)
+{
+    constexpr uint64_t OFFSET{14695981039346656037ull};
+    constexpr uint64_t PRIME{1099511628211ull};
+
+    uint64_t h{OFFSET};
+    auto feed = [&h](const void * data, const size_t SIZE) {
+        const auto * bytes{static_cast<const unsigned char *>(data)};
+        for (size_t i = 0; i < SIZE; ++i) h = (h ^ bytes[i]) * PRIME;
+    };
+
+    const uint64_t COUNTS[2]{vertices.size(), triangles.size()};
+    feed(COUNTS, sizeof(COUNTS));
+    for (const auto & vertex : vertices) feed(vertex.data(), 3 * sizeof(float));
+    for (const auto & triangle : triangles)
+    {
+        const uint64_t INDICES[3]{triangle[0], triangle[1], triangle[2]};
+        feed(INDICES, sizeof(INDICES));
+    }
+    return h;
+}
+
+bool imp::MeshRegistry::equals(const Model & model, const std::vector<fcl::Vector3f> & vertices,
+                               const std::vector<fcl::Triangle> & triangles)
+{
+    if (size_t(model.num_vertices) != vertices.size() || size_t(model.num_tris) != triangles.size())
+        return false;
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        if (std::memcmp(model.vertices[i].data(), vertices[i].data(), 3 * sizeof(float)))
+            return false;
+    }
+    for (size_t t = 0; t < triangles.size(); ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+            if (model.tri_indices[t][k] != triangles[t][k]) return false;
+    }
+    return true;
+}
+
+std::shared_ptr<imp::MeshRegistry::Model>
+imp::MeshRegistry::find(const uint64_t HASH, const std::vector<fcl::Vector3f> & vertices,
+                        const std::vector<fcl::Triangle> & triangles)
+{
+    auto [it, end] = _models.equal_range(HASH);
+    while (it != end)
+    {
+        auto model = it->second.lock();
+        if (!model)
+        {
+            it = _models.erase(it);
+            continue;
+        }
+        if (equals(*model, vertices, triangles)) return model; // collisions are verified
+        ++it;
+    }
+    return nullptr;
+}
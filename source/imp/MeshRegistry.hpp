@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "fcl/fcl.h"
+
+namespace imp
+{
+
+/**
+ * @brief Content addressed cache of built BVH models. Identical meshes (same vertex and
+ * triangle buffers) share one model, which is referenced by every collision object using it.
+ * Entries are weak, a model is released with its last object. All methods are thread safe.
+ */
+class MeshRegistry
+{
+    /////////
+    // nested
+    /////////
+public:
+    using Model = fcl::BVHModel<fcl::OBBf>;
+
+    /////////
+    // data
+    /////////
+private:
+    std::mutex _mutex;
+    std::unordered_multimap<uint64_t, std::weak_ptr<Model>> _models; // by content hash
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Returns the model of the given mesh, builds it (outside of the lock) if no
+     * identical mesh is registered.
+     */
+    std::shared_ptr<Model> acquire(const std::vector<fcl::Vector3f> & vertices,
+                                   const std::vector<fcl::Triangle> & triangles);
+
+    /**
+     * @brief Number of live models.
+     */
+    size_t size();
+
+    /**
+     * @brief Drops the entries of released models.
+     */
+    void purge();
+
+private:
+    /**
+     * @brief FNV-1a over the vertex and index buffers.
+     */
+    static uint64_t hash(const std::vector<fcl::Vector3f> & vertices,
+                         const std::vector<fcl::Triangle> & triangles);
+
+    /**
+     * @brief Whether the model was built from exactly the given buffers.
+     */
+    static bool equals(const Model & model, const std::vector<fcl::Vector3f> & vertices,
+                       const std::vector<fcl::Triangle> & triangles);
+
+    /**
+     * @brief Live model registered for the mesh, drops released entries of HASH (lock held).
+     */
+    std::shared_ptr<Model> find(const uint64_t HASH, const std::vector<fcl::Vector3f> & vertices,
+                                const std::vector<fcl::Triangle> & triangles);
+};
+
+} // namespace imp
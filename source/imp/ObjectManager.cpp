@@ -1,14 +1,39 @@
 #include "imp/ObjectManager.hpp"
 #include "imp/EST.hpp" 
 #include "imp/WorldTree.hpp"
+#include "imp/metrics/Metrics.hpp"
+#include "imp/time/Tracer.hpp"
 
 void imp::ObjectManager::clear()
 {
-    _movable_bvhs.clear();
-    _ests.clear();
-    _static_bvhs.clear();
-    _static_transforms.clear();
-    _static_collision_objects.clear();
+    {
+        // running builds lose their tickets and are discarded
+        std::scoped_lock guard(_movable_mutex, _static_mutex);
+        _movable_bvhs.clear();
+        _ests.clear();
+        _wtrees.clear();
+        _static_bvhs.clear();
+        _static_transforms.clear();
+        _static_collision_objects.clear();
+        _movable_pending.clear();
+        _static_pending.clear();
+        publishMovables();
+        publishStatics();
+        _scene_version++;
+    }
+    _meshes.purge();
+}
+
+imp::ObjectManager::ObjectManager() { _builder = std::thread(&ObjectManager::build, this); }
+
+imp::ObjectManager::~ObjectManager()
+{
+    {
+        std::lock_guard<std::mutex> guard(_build_mutex);
+        _building = false;
+    }
+    _build_condition.notify_all();
+    _builder.join();
 }
 
 size_t imp::ObjectManager::add(bool movable,                           //
@@ -16,72 +41,189 @@ size_t imp::ObjectManager::add(bool movable,                           //
                                std::vector<fcl::Triangle> & triangles, //
                                const Configuration & config)
 {
-    auto model = std::make_shared<fcl::BVHModel<fcl::OBBf>>();
-    model->beginModel();
-    model->addSubModel(vertices, triangles);
-    model->endModel();
+    auto model = _meshes.acquire(vertices, triangles);
 
-    if (movable)
+    const uint64_t TICKET{_ticket_counter++};
+    const size_t ID{reserve(movable, TICKET)};
+    activate(movable, ID, TICKET, model, config);
+    return ID;
+}
+
+std::vector<size_t> imp::ObjectManager::addAsync(std::vector<Upload> objects)
+{
+    std::vector<size_t> ids;
+    ids.reserve(objects.size());
     {
-        std::lock_guard<std::mutex> guard(_movable_mutex);
-        size_t movable_next = movableNext();
-        if (movable_next == _movable_bvhs.size())
+        std::lock_guard<std::mutex> guard(_build_mutex);
+        for (auto & object : objects)
         {
-            _movable_bvhs.emplace_back(model);
-            _ests.emplace_back(std::make_unique<imp::EST>(*this, movable_next));
-            _wtrees.emplace_back(std::make_shared<imp::WorldTree>(movable_next));
-            return _movable_bvhs.size() - 1;
+            const uint64_t TICKET{_ticket_counter++};
+            ids.emplace_back(reserve(object.Movable, TICKET));
+            _build_queue.emplace_back(Build{ids.back(), TICKET, std::move(object)});
         }
-        else
+    }
+    _build_condition.notify_one();
+    return ids;
+}
+
+std::shared_ptr<imp::EST> imp::ObjectManager::est(size_t id)
+{
+    std::lock_guard<std::mutex> guard(_movable_mutex);
+    return id < _ests.size() ? _ests[id] : nullptr;
+}
+
+std::shared_ptr<imp::WorldTree> imp::ObjectManager::wtree(size_t id)
+{
+    std::lock_guard<std::mutex> guard(_movable_mutex);
+    return id < _wtrees.size() ? _wtrees[id] : nullptr;
+}
+
+void imp::ObjectManager::publishMovables()
+{
+    _movable_models.store(std::make_shared<const Models>(_movable_bvhs));
+}
+
+void imp::ObjectManager::publishStatics()
+{
+    _static_objects.store(std::make_shared<const CollisionObjects>(_static_collision_objects));
+}
+
+imp::ObjectManager::ObjectState imp::ObjectManager::state(bool movable, size_t id)
+{
+    if (movable)
+    {
+        std::lock_guard<std::mutex> guard(_movable_mutex);
+        if (_movable_pending.contains(id)) return ObjectState::Pending;
+        return id < _movable_bvhs.size() && _movable_bvhs[id] ? ObjectState::Ready
+                                                              : ObjectState::Missing;
+    }
+
+    std::lock_guard<std::mutex> guard(_static_mutex);
+    if (_static_pending.contains(id)) return ObjectState::Pending;
+    return id < _static_bvhs.size() && _static_bvhs[id] ? ObjectState::Ready
+                                                        : ObjectState::Missing;
+}
+
+size_t imp::ObjectManager::reserve(bool movable, const uint64_t TICKET)
+{
+    if (movable)
+    {
+        std::lock_guard<std::mutex> guard(_movable_mutex);
+        const size_t ID{movableNext()};
+        if (ID == _movable_bvhs.size())
         {
-            _movable_bvhs[movable_next] = model;
-            _ests[movable_next] = std::make_unique<imp::EST>(*this, movable_next);
-            _wtrees[movable_next] = std::make_shared<imp::WorldTree>(movable_next);
-            return movable_next;
+            _movable_bvhs.emplace_back(nullptr);
+            _ests.emplace_back(nullptr);
+            _wtrees.emplace_back(nullptr);
+            publishMovables();
         }
+        _movable_pending[ID] = TICKET;
+        return ID;
     }
-    else
+
+    std::lock_guard<std::mutex> guard(_static_mutex);
+    const size_t ID{staticNext()};
+    if (ID == _static_bvhs.size())
+    {
+        _static_bvhs.emplace_back(nullptr);
+        _static_transforms.emplace_back();
+        _static_collision_objects.emplace_back(nullptr);
+        publishStatics();
+    }
+    _static_pending[ID] = TICKET;
+    return ID;
+}
+
+bool imp::ObjectManager::activate(bool movable, const size_t ID, const uint64_t TICKET,
+                                  std::shared_ptr<fcl::BVHModel<fcl::OBBf>> model,
+                                  const Configuration & config)
+{
+    if (movable)
+    {
+        std::lock_guard<std::mutex> guard(_movable_mutex);
+        auto it = _movable_pending.find(ID);
+        if (it == _movable_pending.end() || it->second != TICKET) return false;
+        _movable_pending.erase(it);
+
+        _movable_bvhs[ID] = model;
+        _ests[ID] = std::make_shared<imp::EST>(*this, ID);
+        _wtrees[ID] = std::make_shared<imp::WorldTree>(ID);
+        publishMovables();
+        return true;
+    }
+
+    fcl::AABBf box;
     {
         std::lock_guard<std::mutex> guard(_static_mutex);
-        size_t static_next = staticNext();
-        if (static_next == _static_bvhs.size())
-        {
-            _static_bvhs.emplace_back(model);
+        auto it = _static_pending.find(ID);
+        if (it == _static_pending.end() || it->second != TICKET) return false;
+        _static_pending.erase(it);
+
+        auto static_collision_object =
+            std::make_shared<fcl::CollisionObjectf>(model, toFCL(config));
+        box = static_collision_object->getAABB();
+
+        _static_bvhs[ID] = model;
+        _static_transforms[ID] = config;
+        _static_collision_objects[ID] = static_collision_object;
+        publishStatics();
+        _scene_version++;
+    }
 
-            _static_transforms.emplace_back(config);
-            fcl::Transform3f fcl_transform{toFCL(config)};
+    revalidateWorldTrees(box, true);
+    return true;
+}
 
-            auto static_collision_object =
-                std::make_shared<fcl::CollisionObjectf>(model, fcl_transform);
-            _static_collision_objects.emplace_back(static_collision_object);
-            return _static_bvhs.size() - 1;
-        }
-        else
+void imp::ObjectManager::build()
+{
+    std::unique_lock<std::mutex> lock(_build_mutex);
+    while (true)
+    {
+        _build_condition.wait(lock, [this]() { return !_building || !_build_queue.empty(); });
+        if (!_building) break;
+
+        // everything queued so far is built as one batch, one model per task
+        std::vector<Build> batch(std::make_move_iterator(_build_queue.begin()),
+                                 std::make_move_iterator(_build_queue.end()));
+        _build_queue.clear();
+        lock.unlock();
+
+        std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBf>>> models(batch.size());
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int64_t i = 0; i < static_cast<int64_t>(batch.size()); ++i)
+            models[i] = _meshes.acquire(batch[i].Object.Vertices, batch[i].Object.Triangles);
+
+        // builds of removed or cleared slots are dropped
+        for (size_t i = 0; i < batch.size(); ++i)
         {
-            _static_bvhs[static_next] = model;
-            _static_transforms[static_next] = config;
-            fcl::Transform3f fcl_transform{toFCL(config)};
-            _static_collision_objects[static_next] =
-                std::make_shared<fcl::CollisionObjectf>(model, fcl_transform);
-            return static_next;
+            const auto & build{batch[i]};
+            activate(build.Object.Movable, build.ID, build.Ticket, models[i],
+                     build.Object.Transform);
         }
+
+        lock.lock();
     }
 }
 
 bool imp::ObjectManager::collides(size_t movable_id, //
                                   const Configuration & configuration)
 {
-    auto obj =
-        std::make_shared<fcl::CollisionObjectf>(_movable_bvhs[movable_id], toFCL(configuration));
+    time::Span span("collides", 2);
+    const auto MODEL{movableModel(movable_id)};
+    if (!MODEL) return true; // removed meanwhile, fails closed
+    const auto STATICS{_static_objects.load()};
+    auto obj = std::make_shared<fcl::CollisionObjectf>(MODEL, toFCL(configuration));
 
     // collision test // todo ! use fcl::manager
     int collision_count = 0;
-#pragma omp parallel for reduction(+ : collision_count)
-    for (int i = 0; i < _static_bvhs.size(); ++i)
+    int narrow_phase_calls = 0;
+#pragma omp parallel for reduction(+ : collision_count, narrow_phase_calls)
+    for (int64_t i = 0; i < static_cast<int64_t>(STATICS->size()); ++i)
     {
-        auto collision_object = _static_collision_objects[i].get();
+        auto collision_object = (*STATICS)[i].get();
         if (collision_object)
         {
+            narrow_phase_calls++;
             fcl::CollisionRequestf request;
             fcl::CollisionResultf result;
             fcl::collide(obj.get(), collision_object, request, result);
@@ -89,12 +231,16 @@ bool imp::ObjectManager::collides(size_t movable_id, //
         }
     }
 
+    metrics::add(metrics::Counter::CollisionQueries);
+    metrics::add(metrics::Counter::NarrowPhaseCalls, narrow_phase_calls);
     return bool(collision_count);
 }
 
 bool imp::ObjectManager::isCollisionFreePath(size_t movable_id, Configuration start,
-                                             Configuration end)
+                                             Configuration end,
+                                             const CancellationToken * cancellation)
 {
+    time::Span span("collision-free-path", 2);
     int collision_count = 0;
     const size_t POSITIONAL_STEPS{
         size_t((end.Position - start.Position).norm() / PATH_VERIFICATION_POSITIONAL_STEP)};
@@ -106,6 +252,8 @@ bool imp::ObjectManager::isCollisionFreePath(size_t movable_id, Configuration st
 #pragma omp parallel for reduction(+ : collision_count)
     for (int i = 0; i < STEPS + 1; ++i)
     {
+        if (cancellation && cancellation->cancelled()) continue;
+
         float delta{(1.0f / STEPS) * i};
 
         auto position = imp::math::lerp(start.Position, end.Position, delta);
@@ -114,6 +262,10 @@ bool imp::ObjectManager::isCollisionFreePath(size_t movable_id, Configuration st
         collision_count += collides(movable_id, Configuration{position, rotation});
     }
 
+    if (cancellation && cancellation->cancelled()) return false;
+
+    metrics::add(collision_count ? metrics::Counter::EdgesRejected
+                                 : metrics::Counter::EdgesAccepted);
     return !bool(collision_count);
 }
 
@@ -150,11 +302,128 @@ imp::ObjectManager::newLocalClosestWorker(const size_t MOVABLE_ID, const size_t
     return closest;
 }
 
+std::tuple<bool, size_t, std::vector<imp::Configuration>>
+imp::ObjectManager::repairPath(const size_t MOVABLE_ID, const std::vector<Configuration> & path)
+{
+    const size_t N{path.size()};
+    if (N < 2) return std::make_tuple(N && !collides(MOVABLE_ID, path.front()), size_t(0), path);
+
+    // validate all segments at once
+    std::vector<char> valid(N - 1);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(N - 1); ++i)
+        valid[i] = isCollisionFreePath(MOVABLE_ID, path[i], path[i + 1]);
+
+    // gaps are maximal runs [begin, end) of invalid segments
+    std::vector<std::pair<size_t, size_t>> gaps;
+    for (size_t i = 0; i < N - 1;)
+    {
+        if (valid[i])
+        {
+            ++i;
+            continue;
+        }
+        const size_t BEGIN{i};
+        while (i < N - 1 && !valid[i]) ++i;
+        gaps.emplace_back(BEGIN, i);
+    }
+
+    if (gaps.empty()) return std::make_tuple(true, size_t(0), path);
+
+    // poses next to valid segments are free, only the path ends need to be checked
+    if (collides(MOVABLE_ID, path.front()) || collides(MOVABLE_ID, path.back()))
+        return std::make_tuple(false, gaps.size(), path);
+
+    // replan the gaps, each with its own temporary tree. At most PATH_TO_MAX_RUNNING run at
+    // once (every exploration is parallel itself), the workers take the next open gap.
+    std::vector<std::pair<int64_t, std::vector<Configuration>>> repairs(gaps.size());
+    std::atomic<size_t> open{0};
+    auto repair = [&]() {
+        for (size_t g = open++; g < gaps.size(); g = open++)
+        {
+            const size_t LAST{std::min(gaps[g].second + PATH_REPAIR_MAX_MATCHEES - 1,
+                                       g + 1 < gaps.size() ? gaps[g + 1].first : N - 1)};
+            std::vector<std::pair<size_t, Configuration>> matchees;
+            for (size_t i = gaps[g].second; i <= LAST; ++i) matchees.emplace_back(i, path[i]);
+
+            EST est(*this, MOVABLE_ID);
+            repairs[g] = est.explore(path[gaps[g].first], matchees, true, PATH_REPAIR_RUNTIME);
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (size_t w = 1; w < std::min(gaps.size(), PATH_TO_MAX_RUNNING); ++w)
+        workers.emplace_back(std::async(std::launch::async, repair));
+    repair();
+    for (auto & worker : workers) worker.get();
+
+    std::vector<Configuration> result;
+    size_t next{0}; // first pose of the original path not yet copied
+    bool successful{true};
+    for (size_t g = 0; g < gaps.size(); ++g)
+    {
+        auto & [matchee, patch] = repairs[g];
+        if (matchee < 0)
+        {
+            successful = false;
+            continue;
+        }
+
+        result.insert(result.end(), path.begin() + next, path.begin() + gaps[g].first + 1);
+        result.insert(result.end(), patch.begin(), patch.end());
+        next = static_cast<size_t>(matchee) + 1;
+    }
+    result.insert(result.end(), path.begin() + next, path.end());
+
+    if (!successful) return std::make_tuple(false, gaps.size(), path);
+    return std::make_tuple(true, gaps.size(), result);
+}
+
+std::pair<std::vector<std::pair<size_t, imp::Configuration>>, bool>
+imp::ObjectManager::selectMatchees(const size_t MOVABLE_ID,
+                                   const std::vector<Configuration> & u_path)
+{
+    const size_t N{u_path.size()};
+
+    // check the whole u path at once
+    const int64_t TRACE_REQUEST{time::request()};
+    std::vector<char> u_path_free(N);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(N); ++i)
+    {
+        time::TraceScope scope(TRACE_REQUEST);
+        u_path_free[i] = !collides(MOVABLE_ID, u_path[i]);
+    }
+
+    // every pose ending a free section is a matchee
+    std::vector<std::pair<size_t, Configuration>> matchees;
+    size_t counters = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        counters = u_path_free[i] ? counters + 1 : 0;
+        if (counters >= EST_MIN_MATCHEE_SECTION) matchees.emplace_back(i, u_path[i]);
+    }
+
+    // no collision free pose: approach the end of the u path
+    const bool COLLISION_FREE_MATCHEE{!matchees.empty()};
+    if (!COLLISION_FREE_MATCHEE)
+        matchees.emplace_back(size_t(0), N ? u_path.back() : Configuration());
+    return std::make_pair(std::move(matchees), COLLISION_FREE_MATCHEE);
+}
+
 std::pair<bool, imp::Configuration>
 imp::ObjectManager::newLocalClosest(const size_t MOVABLE_ID,     //
                                     const Configuration & start, //
-                                    const Configuration & end)
+                                    const Configuration & end,   //
+                                    const bool PARALLEL)
 {
+    time::Span span("new-local-closest", 2);
+    if (!PARALLEL)
+    {
+        auto closest{newLocalClosestWorker(MOVABLE_ID, REPAIR_NUM_SAMPLES, start, end)};
+        return std::make_pair(std::get<0>(closest), std::get<2>(closest));
+    }
+
     const auto SAMPLES_PER_TASK = math::sdiv<size_t>(REPAIR_NUM_SAMPLES, MAX_OMP_THREADS);
 
     std::array<std::future<std::tuple<bool, float, Configuration>>, MAX_OMP_THREADS> tasks;
@@ -190,7 +459,7 @@ size_t imp::ObjectManager::movableNext()
     size_t result = 0;
     for (; result < _movable_bvhs.size(); ++result)
     {
-        if (!_movable_bvhs[result]) break;
+        if (!_movable_bvhs[result] && !_movable_pending.contains(result)) break;
     }
     return result;
 }
@@ -200,7 +469,7 @@ size_t imp::ObjectManager::staticNext()
     size_t result = 0;
     for (; result < _static_bvhs.size(); ++result)
     {
-        if (!_static_bvhs[result]) break;
+        if (!_static_bvhs[result] && !_static_pending.contains(result)) break;
     }
     return result;
 }
@@ -209,29 +478,72 @@ void imp::ObjectManager::remove(bool movable, size_t index)
 {
     if (movable)
     {
-        if (index >= _movable_bvhs.size()) return;
         std::lock_guard<std::mutex> guard(_movable_mutex);
+        if (index >= _movable_bvhs.size()) return;
+        _movable_pending.erase(index); // a running build is discarded
         _movable_bvhs[index] = nullptr;
         _ests[index] = nullptr;
+        publishMovables();
     }
     else
     {
-        if (index >= _static_bvhs.size()) return;
-        std::lock_guard<std::mutex> guard(_static_mutex);
-        _static_bvhs[index] = nullptr;
-        _static_collision_objects[index] = nullptr;
+        std::optional<fcl::AABBf> box;
+        {
+            std::lock_guard<std::mutex> guard(_static_mutex);
+            if (index >= _static_bvhs.size()) return;
+            _static_pending.erase(index); // a running build is discarded
+            if (_static_collision_objects[index])
+                box = _static_collision_objects[index]->getAABB();
+            _static_bvhs[index] = nullptr;
+            _static_collision_objects[index] = nullptr;
+            publishStatics();
+        }
+        if (box.has_value()) revalidateWorldTrees(box.value(), false);
+    }
+}
+
+void imp::ObjectManager::revalidateWorldTrees(const fcl::AABBf & box, bool added)
+{
+    std::vector<std::pair<size_t, std::shared_ptr<WorldTree>>> wtrees;
+    {
+        std::lock_guard<std::mutex> guard(_movable_mutex);
+        const size_t N{std::min(_movable_bvhs.size(), _wtrees.size())};
+        for (size_t i = 0; i < N; ++i)
+            if (_movable_bvhs[i] && _wtrees[i]) wtrees.emplace_back(i, _wtrees[i]);
+    }
+
+    for (auto & [id, wtree] : wtrees)
+    {
+        metrics::add(added ? metrics::Counter::RoadmapEdgesInvalidated
+                           : metrics::Counter::RoadmapEdgesRestored,
+                     wtree->revalidateEdges(*this, box, added));
     }
 }
 
+std::vector<imp::ObjectManager::StaticObject> imp::ObjectManager::staticObjects()
+{
+    std::lock_guard<std::mutex> guard(_static_mutex);
+
+    std::vector<StaticObject> result;
+    for (size_t i = 0; i < _static_bvhs.size(); ++i)
+    {
+        if (_static_bvhs[i])
+            result.emplace_back(StaticObject{_static_bvhs[i], _static_transforms[i]});
+    }
+    return result;
+}
+
 std::string imp::ObjectManager::toJSON() const
 {
+    std::lock_guard<std::mutex> guard(_static_mutex);
     std::stringstream ss;
     ss << "[";
     for (size_t i = 0; i < _static_collision_objects.size(); ++i)
     {
-        ss << "{";
         auto & so{_static_collision_objects[i]};
         auto & sb{_static_bvhs[i]};
+        if (!so || !sb) continue; // pending or removed
+        ss << (ss.tellp() > 1 ? ",{" : "{");
 
         fcl::Vector3f Position = so->getTranslation();
         fcl::Matrix3f rot = so->getRotation();
@@ -258,7 +570,6 @@ std::string imp::ObjectManager::toJSON() const
             if (t != sb->num_tris - 1) ss << ",";
         }
         ss << "]}";
-        if (i != _static_collision_objects.size() - 1) ss << ",";
     }
     ss << "]";
     return ss.str();
@@ -1,16 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "fcl/fcl.h"
 #include "fcl/math/motion/interp_motion.h"
 
+#include "imp/Cancellation.hpp"
 #include "imp/Configuration.hpp"
+#include "imp/MeshRegistry.hpp"
 #include "imp/Settings.hpp"
 #include "imp/math/Math.hpp"
 #include "imp/random/Sampler.hpp"
@@ -22,6 +30,11 @@ namespace imp
 class EST;
 class WorldTree;
 
+namespace io
+{
+class Snapshot;
+}
+
 /**
  * @brief Manager for scene objects.
  *
@@ -29,22 +42,98 @@ class WorldTree;
  */
 class ObjectManager : public imp::json::JSONable
 {
+    friend io::Snapshot;
+
+    /////////
+    // nested
+    /////////
+public:
+    struct StaticObject
+    {
+        std::shared_ptr<fcl::BVHModel<fcl::OBBf>> Model;
+        Configuration Transform;
+    };
+
+    /**
+     * @brief Mesh of an object whose model is built in the background (see addAsync).
+     */
+    struct Upload
+    {
+        bool Movable{false};
+        std::vector<fcl::Vector3f> Vertices;
+        std::vector<fcl::Triangle> Triangles;
+        Configuration Transform;
+    };
+
+    enum class ObjectState
+    {
+        Missing,
+        Pending, // reserved, the model is still being built
+        Ready
+    };
+
+private:
+    using Models = std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBf>>>;
+    using CollisionObjects = std::vector<std::shared_ptr<fcl::CollisionObjectf>>;
+
+    struct Build
+    {
+        size_t ID{0};
+        uint64_t Ticket{0};
+        Upload Object;
+    };
+
     /////////
     // data
     /////////
 private:
+    MeshRegistry _meshes; // identical meshes share their model
+
     // movable data
     std::mutex _movable_mutex;
     std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBf>>> _movable_bvhs;
-    std::vector<std::unique_ptr<EST>> _ests;
+    std::vector<std::shared_ptr<EST>> _ests;
     std::vector<std::shared_ptr<WorldTree>> _wtrees;
 
     // static data
-    std::mutex _static_mutex;
+    mutable std::mutex _static_mutex;
     std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBf>>> _static_bvhs;
     std::vector<Configuration> _static_transforms;
     std::vector<std::shared_ptr<fcl::CollisionObjectf>> _static_collision_objects;
 
+    // immutable copies of the movable models and static collision objects for the queries, which
+    // load them once instead of locking. Replaced under the object mutex of their kind (see
+    // publishMovables, publishStatics) whenever a slot changes.
+    std::atomic<std::shared_ptr<const Models>> _movable_models{std::make_shared<const Models>()};
+    std::atomic<std::shared_ptr<const CollisionObjects>> _static_objects{
+        std::make_shared<const CollisionObjects>()};
+
+    // reserved slots (slot -> ticket) of objects under construction, guarded by the object mutex
+    // of their kind. A removed or cleared slot loses its ticket, its build is then discarded.
+    std::unordered_map<size_t, uint64_t> _movable_pending;
+    std::unordered_map<size_t, uint64_t> _static_pending;
+    std::atomic<uint64_t> _ticket_counter{0};
+
+    // incremented whenever a static object becomes active
+    std::atomic<uint64_t> _scene_version{0};
+
+    // background construction
+    std::mutex _build_mutex;
+    std::condition_variable _build_condition;
+    std::deque<Build> _build_queue;
+    bool _building{true};
+    std::thread _builder;
+
+    /////////
+    // constructors
+    /////////
+public:
+    ObjectManager();
+    ~ObjectManager();
+
+    ObjectManager(const ObjectManager &) = delete;
+    ObjectManager & operator=(const ObjectManager &) = delete;
+
     /////////
     // properties
     /////////
@@ -52,15 +141,35 @@ public:
     /**
      * @brief Checks if the given id is a valid movable id.
      */
-    bool hasMovable(size_t id) { return _movable_bvhs.size() > id; }
+    bool hasMovable(size_t id) { return bool(movableModel(id)); }
+
+    /**
+     * @brief Number of movable slots (including removed ones).
+     */
+    size_t movableCount() { return _movable_models.load()->size(); }
 
-    inline std::unique_ptr<EST> & est(size_t id) { return _ests[id]; }
-    inline std::shared_ptr<WorldTree> & wtree(size_t id) { return _wtrees[id]; }
+    /**
+     * @brief Number of distinct models (identical meshes share one).
+     */
+    size_t meshCount() { return _meshes.size(); }
+
+    /**
+     * @brief Changes whenever a static object was added. Explorations stamp it on their start,
+     * their edges are revalidated on join if the scene changed meanwhile.
+     */
+    uint64_t sceneVersion() const { return _scene_version.load(); }
+
+    /**
+     * @brief The exploration and world tree of a movable (nullptr if there is none). Holders keep
+     * them alive if the movable is removed or the scene cleared meanwhile.
+     */
+    std::shared_ptr<EST> est(size_t id);
+    std::shared_ptr<WorldTree> wtree(size_t id);
 
     /**
      * @brief Checks if the given id is a valid movable id.
      */
-    bool hasStatic(size_t id) { return _static_bvhs.size() > id; }
+    bool hasStatic(size_t id) { return _static_objects.load()->size() > id; }
 
     /**
      * @brief Resets this instance.
@@ -88,6 +197,18 @@ public:
                std::vector<fcl::Triangle> & triangles, //
                const Configuration & config);
 
+    /**
+     * @brief Reserves ids for the objects and returns immediately, their models are built in
+     * parallel on a background thread. Each object becomes visible to collision queries at once
+     * when its model is ready (see state).
+     */
+    std::vector<size_t> addAsync(std::vector<Upload> objects);
+
+    /**
+     * @brief Whether the object exists, is still being built or is ready.
+     */
+    ObjectState state(bool movable, size_t id);
+
     /**
      * @brief Runs a simple collision query for the movable object with the given id and
      * configuration against ALL environment objects.
@@ -103,10 +224,12 @@ public:
      * @param movable_id
      * @param start
      * @param end
+     * @param cancellation Optional, the remaining steps are skipped once it is cancelled.
      * @return true
-     * @return false
+     * @return false (also if cancelled)
      */
-    bool isCollisionFreePath(size_t movable_id, Configuration start, Configuration end);
+    bool isCollisionFreePath(size_t movable_id, Configuration start, Configuration end,
+                             const CancellationToken * cancellation = nullptr);
 
     /**
      * @brief Generate a new local configuration.
@@ -114,17 +237,70 @@ public:
      * @param MOVABLE_ID
      * @param start
      * @param end
+     * @param PARALLEL Whether to spread the samples over tasks, callers that are parallel
+     * already sample on their own thread.
      * @return Configuration
      */
     std::pair<bool, Configuration> newLocalClosest(const size_t MOVABLE_ID,     //
                                                    const Configuration & start, //
-                                                   const Configuration & end);
+                                                   const Configuration & end,   //
+                                                   const bool PARALLEL = true);
+
+    /**
+     * @brief Repairs a previously planned path (including its start pose) after scene changes.
+     * All segments are validated in parallel, every run of invalid segments is replanned by a
+     * temporary EST rooted at the last valid pose, which may reconnect to any of the next
+     * PATH_REPAIR_MAX_MATCHEES valid poses. At most PATH_TO_MAX_RUNNING gaps are replanned at
+     * once, the calling thread is one of the workers.
+     *
+     * @return Whether all gaps could be repaired, the number of gaps and the patched path (the
+     * original path on failure).
+     */
+    std::tuple<bool, size_t, std::vector<Configuration>>
+    repairPath(const size_t MOVABLE_ID, const std::vector<Configuration> & path);
+
+    /**
+     * @brief Matchee selection of /path-to: every pose of the u path that ends a collision free
+     * section of at least EST_MIN_MATCHEE_SECTION poses (checked in parallel).
+     *
+     * @return The matchees (u path index, pose) and whether they are collision free. Without a
+     * free section the end of the u path is the only matchee, to be approached.
+     */
+    std::pair<std::vector<std::pair<size_t, Configuration>>, bool>
+    selectMatchees(const size_t MOVABLE_ID, const std::vector<Configuration> & u_path);
 
     std::string toJSON() const override;
 
+    /**
+     * @brief Returns the current static objects. Only the (immutable) models are shared, this
+     * is cheap enough to be done on every exploration.
+     */
+    std::vector<StaticObject> staticObjects();
+
     float bounding(const size_t MOVABLE_ID)
     {
-        return _movable_bvhs[MOVABLE_ID]->aabb_radius;
+        const auto model{movableModel(MOVABLE_ID)};
+        return model ? model->aabb_radius : 0.0f;
+    }
+
+    /**
+     * @brief Radius around the origin of the movable that contains it in any rotation (0 for
+     * removed movables).
+     */
+    float sweepRadius(const size_t MOVABLE_ID)
+    {
+        const auto model{movableModel(MOVABLE_ID)};
+        return model ? model->aabb_center.norm() + model->aabb_radius : 0.0f;
+    }
+
+    /**
+     * @brief Model of a movable, nullptr if the id is unknown, pending or removed (queries of
+     * running explorations may outlive their movable).
+     */
+    std::shared_ptr<fcl::BVHModel<fcl::OBBf>> movableModel(const size_t MOVABLE_ID)
+    {
+        const auto MODELS{_movable_models.load()};
+        return MOVABLE_ID < MODELS->size() ? (*MODELS)[MOVABLE_ID] : nullptr;
     }
 
 protected:
@@ -145,6 +321,35 @@ protected:
 
     size_t staticNext();
 
+    /**
+     * @brief Reserves the next free slot for the given ticket.
+     */
+    size_t reserve(bool movable, const uint64_t TICKET);
+
+    /**
+     * @brief Installs the model in its reserved slot. Returns false (and drops the model) if the
+     * slot was removed or cleared in the meantime.
+     */
+    bool activate(bool movable, const size_t ID, const uint64_t TICKET,
+                  std::shared_ptr<fcl::BVHModel<fcl::OBBf>> model, const Configuration & config);
+
+    /**
+     * @brief Replace the query copies of the movable models / static collision objects, callers
+     * hold the object mutex of the kind.
+     */
+    void publishMovables();
+    void publishStatics();
+
+    /**
+     * @brief Worker of addAsync, builds the queued models in batches.
+     */
+    void build();
+
+    /**
+     * @brief Rechecks the world tree edges near a static object that was added or removed.
+     */
+    void revalidateWorldTrees(const fcl::AABBf & box, bool added);
+
     /////////
     // methods
     /////////
@@ -0,0 +1,114 @@
+#include "imp/RoadmapGrower.hpp"
+
+#include <omp.h>
+
+#include "imp/EST.hpp"
+#include "imp/WorldTree.hpp"
+
+imp::RoadmapGrower::RoadmapGrower(ObjectManager & manager) : _manager{manager}
+{
+#ifdef BACKGROUND_GROWTH
+    _worker = std::thread(&RoadmapGrower::run, this);
+#endif
+}
+
+imp::RoadmapGrower::~RoadmapGrower()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _running = false;
+        _cancellation.cancel();
+    }
+    _condition.notify_all();
+    if (_worker.joinable()) _worker.join();
+}
+
+imp::RoadmapGrower::Activity imp::RoadmapGrower::activity()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _active++;
+
+    // the running round stops after its current step, requests may then modify the scene. A
+    // round that did not start exploring yet sees the cancelled token at once.
+    _cancellation.cancel();
+    _condition.wait(lock, [this]() { return !_growing; });
+    return Activity(this);
+}
+
+void imp::RoadmapGrower::release()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _active--;
+    _idle = time::Timer();
+}
+
+void imp::RoadmapGrower::hint(size_t movable_id, const std::vector<Configuration> & goals)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto & remembered{_goals[movable_id]};
+    remembered.insert(remembered.end(), goals.begin(), goals.end());
+    if (remembered.size() > GROWTH_MAX_GOALS)
+        remembered.erase(remembered.begin(), remembered.end() - GROWTH_MAX_GOALS);
+}
+
+void imp::RoadmapGrower::run()
+{
+    omp_set_num_threads(1); // a single core, requests keep the others
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running)
+    {
+        _condition.wait_for(lock, GROWTH_IDLE_DELAY, [this]() { return !_running; });
+        if (!_running) break;
+        if (_active || _idle.elapsed() < GROWTH_IDLE_DELAY) continue;
+
+        // round robin over the movables with a world tree
+        const size_t MOVABLES{_manager.movableCount()};
+        if (!MOVABLES) continue;
+        const size_t ID{_next_movable++ % MOVABLES};
+        if (!_manager.hasMovable(ID)) continue;
+
+        auto & sampler{random::Sampler()};
+        std::optional<Configuration> goal;
+        if (auto it = _goals.find(ID); it != _goals.end() && !it->second.empty())
+            goal = it->second[std::min(it->second.size() - 1,
+                                       static_cast<size_t>(sampler.rand() * it->second.size()))];
+
+        lock.unlock();
+        if (auto wtree{_manager.wtree(ID)}; wtree)
+        {
+            if (!goal.has_value()) goal = wtree->sample(sampler.rand());
+            if (goal.has_value()) grow(ID, wtree, goal.value());
+        }
+        lock.lock();
+    }
+}
+
+void imp::RoadmapGrower::grow(size_t movable_id, std::shared_ptr<WorldTree> wtree,
+                              const Configuration & goal)
+{
+    const auto ROOT{wtree->position()};
+    if (!ROOT.has_value()) return;
+
+    EST est(_manager, movable_id);
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (_active || !_running) return;
+        _cancellation.reset(); // no activity() is waiting, nobody polls the token
+        _growing = true;
+    }
+
+    std::vector<std::pair<size_t, Configuration>> matchees{std::make_pair(size_t(0), goal)};
+    est.explore(ROOT.value(), matchees, true, GROWTH_RUNTIME, &_cancellation);
+
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _growing = false;
+    }
+    _condition.notify_all();
+
+    // a preempted tree is smaller but every node is valid, joining moves its node buffer in
+    // (see WorldTree::join for the lock hold). The position may have moved meanwhile, join
+    // rejects the tree then.
+    wtree->join(est, false);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "imp/Cancellation.hpp"
+#include "imp/Configuration.hpp"
+#include "imp/ObjectManager.hpp"
+#include "imp/Settings.hpp"
+
+namespace imp
+{
+
+class EST;
+class WorldTree;
+
+/**
+ * @brief Grows the world trees of the movables on a single low priority thread while no
+ * request is active (only with BACKGROUND_GROWTH). Each round explores from the current
+ * position of a movable towards one of its recent goals (or a random roadmap node) and joins
+ * the result without moving the position. Requests hold an Activity, acquiring one stops the
+ * running round immediately.
+ */
+class RoadmapGrower
+{
+    /////////
+    // nested
+    /////////
+public:
+    /**
+     * @brief Marks a request as active for its lifetime.
+     */
+    class Activity
+    {
+    private:
+        RoadmapGrower * _grower;
+
+    public:
+        Activity(RoadmapGrower * grower) : _grower{grower} {}
+        Activity(Activity && other) : _grower{other._grower} { other._grower = nullptr; }
+        Activity(const Activity &) = delete;
+        ~Activity()
+        {
+            if (_grower) _grower->release();
+        }
+    };
+
+    /////////
+    // data
+    /////////
+private:
+    ObjectManager & _manager;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _running{true};
+    size_t _active{0};
+    time::Timer _idle; // since the last request finished
+    bool _growing{false};
+    CancellationToken _cancellation; // parent of the running round, cancelled by activity()
+    size_t _next_movable{0};
+
+    std::unordered_map<size_t, std::vector<Configuration>> _goals;
+
+    std::thread _worker;
+
+    /////////
+    // constructors
+    /////////
+public:
+    RoadmapGrower(ObjectManager & manager);
+    ~RoadmapGrower();
+
+    RoadmapGrower(const RoadmapGrower &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Marks a request as active. A running round is stopped, returns once it left the
+     * exploration.
+     */
+    Activity activity();
+
+    /**
+     * @brief Remembers goals of a movable, later rounds explore towards them.
+     */
+    void hint(size_t movable_id, const std::vector<Configuration> & goals);
+
+private:
+    void release();
+    void run();
+    void grow(size_t movable_id, std::shared_ptr<WorldTree> wtree, const Configuration & goal);
+};
+
+} // namespace imp
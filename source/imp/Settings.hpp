@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <numbers>
 #include <string>
 
@@ -13,12 +14,32 @@ using namespace std::chrono_literals;
 /**************************************************************************************************/
 
 // #define DUMP_REQUESTS
+// #define RECORD_REQUESTS // append-only binary request log (imp-replay, tools/replay.py)
+// #define DETERMINISTIC_EST // seeded, thread count independent explorations (benchmarking)
+// #define BACKGROUND_GROWTH // grow the world trees while the server is idle
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // server settings
 inline const char * HOST_IP = "192.168.188.99";
 constexpr int HOST_PORT = 8000;
 constexpr int MAX_OMP_THREADS = 6;
+constexpr size_t SERVER_ASYNC_WORKERS{4}; // coroutine processors, only O(1) handlers run inline
+constexpr size_t SERVER_BLOCKING_WORKERS{8}; // threads of the handlers that touch the scene
+constexpr imp::time::duration_t SERVER_BLOCKING_POLL_INTERVAL{1ms}; // checks of offloaded answers
+constexpr imp::time::duration_t PATH_TO_POLL_INTERVAL{10ms};  // readiness checks of waiting gets
+constexpr imp::time::duration_t PATH_TO_WAIT_MAX_TIMEOUT{30s}; // upper bound of /path-to-wait
+constexpr imp::time::duration_t PATH_TO_STREAM_INTERVAL{50ms}; // progress frames of /path-to-stream
+constexpr imp::time::duration_t PATH_TO_STREAM_WRITE_TIMEOUT{10s}; // stalled streams are dropped
+constexpr size_t PATH_TO_STREAM_MAX_INCOMING{1 << 16}; // undecoded client bytes of a stream
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// path-to scheduling settings
+constexpr size_t PATH_TO_MAX_RUNNING{2};            // concurrent explorations
+constexpr size_t PATH_TO_MAX_QUEUED{32};            // waiting explorations, more are shed (503)
+constexpr size_t PATH_TO_MAX_QUEUED_PER_CLIENT{8};  // waiting explorations of a single client
+constexpr imp::time::duration_t PATH_TO_RESULT_TTL{60s}; // unclaimed results are dropped after
+constexpr imp::time::duration_t PATH_TO_ABORT_POLL_INTERVAL{1ms}; // acknowledgement checks
+constexpr imp::time::duration_t PATH_TO_ABORT_TIMEOUT{1s}; // /path-to-abort answers 202 after
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // path verification settings
@@ -32,9 +53,17 @@ constexpr float REPAIR_MAX_ROTATIONAL_DISTANCE{std::numbers::pi_v<float> * 0.3f}
 constexpr size_t REPAIR_NUM_SAMPLES = 32;
 constexpr size_t REPAIR_MAX_SAMPLE_TRIES = 16;
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// path repair settings
+constexpr imp::time::duration_t PATH_REPAIR_RUNTIME{500ms}; // exploration budget per gap
+constexpr size_t PATH_REPAIR_MAX_MATCHEES{8}; // poses behind a gap a repair may reconnect to
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // est settings
-constexpr size_t EST_MAX_NEW_SAMPLES = 6 * 6;
+constexpr size_t EST_MAX_NEW_SAMPLES = 64 * MAX_OMP_THREADS; // upper bound of the batch size
+constexpr size_t EST_TARGET_NEW_NODES_PER_WORKER{6};        // accepted nodes per worker and step
+constexpr float EST_MIN_ACCEPTANCE_RATE{0.02f};
+constexpr float EST_ACCEPTANCE_SMOOTHING{0.3f};
 
 constexpr float EST_SAMPLE_MIN_POSITIONAL_DISTANCE{0.005f};
 constexpr float EST_SAMPLE_MAX_POSITIONAL_DISTANCE{0.015f};
@@ -55,6 +84,50 @@ constexpr size_t EST_DOMAIN_ROTATION_INCREASE_STEP{EST_DOMAIN_POSITIONAL_INCREAS
 constexpr float EST_DOMAIN_INITIAL_ROTATION_LIMIT{std::numbers::pi_v<float> * 0.1};
 constexpr float EST_BIASED_SAMPLE_PROPABILITY{.4f};
 
+constexpr uint64_t EST_DETERMINISTIC_SEED{0};
+constexpr size_t EST_DETERMINISTIC_WORKERS{MAX_OMP_THREADS}; // replaces the real worker count
+constexpr size_t EST_DETERMINISTIC_MAX_STEPS{256};           // replaces the runtime limit
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// world tree settings
+constexpr float WORLD_TREE_DOMAIN_EXTENT{100.0f}; // positional half extent of the kd-tree domain
+constexpr size_t WORLD_TREE_MAX_NODES{1 << 18};    // node budget, pruning starts above
+constexpr size_t WORLD_TREE_PRUNE_TARGET{WORLD_TREE_MAX_NODES * 3 / 4}; // size after pruning
+constexpr size_t WORLD_TREE_MAX_CHUNKS{64}; // node chunks (one per join) before merging
+constexpr float WORLD_TREE_EDGE_INDEX_MAX_TAIL{0.25f}; // unindexed edges (linearly scanned)
+constexpr float ROADMAP_CONNECT_POSITIONAL_DISTANCE{0.05f};
+constexpr float ROADMAP_CONNECT_ROTATIONAL_DISTANCE{0.4f * std::numbers::pi_v<float>};
+constexpr size_t ROADMAP_MAX_CONNECTIONS{8}; // validated edges tried per start / matchee
+constexpr size_t ROADMAP_MAX_MATCHEES{16};   // matchees (in u path order) tried per query
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// background growth settings (BACKGROUND_GROWTH)
+constexpr imp::time::duration_t GROWTH_IDLE_DELAY{500ms}; // quiet time before growing starts
+constexpr imp::time::duration_t GROWTH_RUNTIME{1s};       // exploration budget per round
+constexpr size_t GROWTH_MAX_GOALS{16};                     // remembered goals per movable
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// request log settings (RECORD_REQUESTS)
+inline const char * REQUEST_LOG_FILENAME = "requests.impr";
+constexpr bool REQUEST_LOG_TIMING{true}; // capture handler durations
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// snapshot settings (/snapshot-save, /snapshot-load)
+inline const char * SNAPSHOT_DIRECTORY = "snapshots"; // client filenames resolve inside
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// tracing settings (PUT /trace)
+constexpr size_t TRACE_LEVEL{1}; // 0 = off, 1 = handlers and pipeline phases, 2 = + queries
+constexpr size_t TRACE_BUFFER_SIZE{1 << 14}; // spans kept per thread
+constexpr size_t TRACE_EXPORT_MAX_SPANS{1 << 16}; // spans per export, the latest are written
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// est dump settings
+constexpr size_t EST_DUMP_SAMPLING_INTERVAL{0}; // binary dump of every n-th exploration, 0 = off
+constexpr size_t EST_DUMP_MAX_PENDING{4};       // further dumps are dropped while writing
+constexpr size_t EST_DUMP_MAX_FILES{256};       // per process, later dumps are dropped
+inline const char * EST_DUMP_DIRECTORY = "est-dumps";
+
 /**************************************************************************************************/
 /* RUNTIME CONFIGURATION **************************************************************************/
 /**************************************************************************************************/
@@ -1,32 +1,446 @@
 #include "WorldTree.hpp"
 #include "EST.hpp"
+#include "metrics/Metrics.hpp"
 
-bool imp::WorldTree::join(imp::EST & est)
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+
+bool imp::WorldTree::join(imp::EST & est, bool follow)
 {
-    std::lock_guard<std::mutex> guard_est(est._explore_mutex);
-    std::lock_guard<std::mutex> guard_wt(_edit_mtx);
-    
-    if (Distance(_nodes[_position].Config, est._nodes[0].Config) < 1e-10)
-    {
-        const size_t NODE_OFFSET{_nodes.size()};
+    std::unique_lock<std::mutex> guard_est(est._explore_mutex);
 
-        for (size_t i = 0; i < est._nodes.size(); ++i)
+    // an exploration that started before a static object was added is rechecked (outside of the
+    // tree lock). Objects added after the check revalidate the adopted edges themselves, as
+    // ObjectManager::revalidateWorldTrees waits for the tree lock.
+    std::vector<char> valid(est._nodes.size(), 1);
+    std::unique_lock<std::mutex> guard_wt(_edit_mtx, std::defer_lock);
+    while (true)
+    {
+        const uint64_t VERSION{est._manager.sceneVersion()};
+        if (VERSION != est._scene_version)
         {
-            WorldNode node = est._nodes[i];
-            node.IsRoot = false;
-            node.Parent = i ? NODE_OFFSET + node.Parent : _position;
-            _nodes.emplace_back(node);
+            metrics::add(metrics::Counter::StaleJoins);
+            const auto & NODES{est._nodes};
+#pragma omp parallel for
+            for (int64_t i = 1; i < static_cast<int64_t>(NODES.size()); ++i)
+            {
+                if (valid[i])
+                    valid[i] = est._manager.isCollisionFreePath(
+                        _MOVABLE_ID, NODES[i].Config, NODES[NODES[i].Parent].Config);
+            }
+            est._scene_version = VERSION;
         }
-        _position = NODE_OFFSET + est._last_solution;
+
+        guard_wt.lock();
+        if (est._manager.sceneVersion() == VERSION) break;
+        guard_wt.unlock();
+    }
+
+    if (size() && !est._nodes.empty() &&
+        Distance(_nodes[_position].Config, est._nodes[0].Config) < 1e-10)
+    {
+        const size_t NODE_OFFSET{size()};
+        _edge_valid.resize(NODE_OFFSET, 1);
+        _edge_valid.insert(_edge_valid.end(), valid.begin(), valid.end());
+
+        // adopt the node buffer as a chunk, its parents are resolved through the chunk link
+        _nodes.adopt(std::move(est._nodes), WorldChunkLink{static_cast<uint32_t>(NODE_OFFSET),
+                                                           static_cast<uint32_t>(_position)});
+        est._nodes.clear();
+        est._sorted_indices.clear();
+        if (follow) _position = NODE_OFFSET + est._last_solution;
+
+        // indexing (keeping the est ratings) is deferred to the next query
+        guard_est.unlock();
+        prune(guard_wt);
         return true;
     }
     else
     {
-        std::stringstream ss;
-        JSON(_nodes[_position].Config)
-        ss << "\n";
-        JSON(est._nodes[0].Config)
-        std::cout << ss.str() << std::endl;
+        if (size() && !est._nodes.empty()) metrics::add(metrics::Counter::RejectedJoins);
         return false;
     }
+}
+
+std::optional<imp::RoadmapPath>
+imp::WorldTree::roadmap(ObjectManager & manager, const Configuration & start,
+                        const std::vector<std::pair<size_t, Configuration>> & matchees)
+{
+    std::lock_guard<std::mutex> guard(_edit_mtx);
+
+    if (!size() || matchees.empty()) return std::nullopt;
+    _edge_valid.resize(size(), 1);
+    _kdtree->insertBulk();
+
+    const float BOUNDING{manager.bounding(_MOVABLE_ID)};
+    const DistancePair CONNECT{ROADMAP_CONNECT_POSITIONAL_DISTANCE,
+                               ROADMAP_CONNECT_ROTATIONAL_DISTANCE};
+
+    // closest nodes around c with a collision free straight edge, sorted by distance
+    auto connect = [&](const Configuration & c) {
+        std::vector<std::pair<uint32_t, float>> candidates;
+        for (size_t i : _kdtree->within(c, CONNECT))
+            candidates.emplace_back(i, Distance(c, _nodes[i].Config, BOUNDING));
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const auto & a, const auto & b) { return a.second < b.second; });
+        if (candidates.size() > ROADMAP_MAX_CONNECTIONS)
+            candidates.resize(ROADMAP_MAX_CONNECTIONS);
+
+        std::vector<char> valid(candidates.size(), 0);
+#pragma omp parallel for
+        for (int64_t k = 0; k < static_cast<int64_t>(candidates.size()); ++k)
+            valid[k] =
+                manager.isCollisionFreePath(_MOVABLE_ID, c, _nodes[candidates[k].first].Config);
+
+        std::vector<std::pair<uint32_t, float>> result;
+        for (size_t k = 0; k < candidates.size(); ++k)
+            if (valid[k]) result.emplace_back(candidates[k]);
+        return result;
+    };
+
+    const auto SOURCES{connect(start)};
+    if (SOURCES.empty()) return std::nullopt;
+
+    // node -> (cost, matchee) of the cheapest edge leaving the roadmap
+    const size_t MATCHEES{std::min(matchees.size(), ROADMAP_MAX_MATCHEES)};
+    std::unordered_map<uint32_t, std::pair<float, size_t>> exits;
+    for (size_t m = 0; m < MATCHEES; ++m)
+        for (const auto & [node, cost] : connect(matchees[m].second))
+            if (auto it = exits.find(node); it == exits.end() || cost < it->second.first)
+                exits[node] = std::make_pair(cost, m);
+    if (exits.empty()) return std::nullopt;
+
+    // children in compressed row storage, the parent links are the other half of the edges
+    const size_t N{size()};
+    const std::vector<uint32_t> PARENTS{parents()};
+    std::vector<uint32_t> offsets(N + 1, 0), children(N);
+    for (uint32_t parent : PARENTS)
+        if (parent != WorldNode::NO_PARENT) offsets[parent + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (uint32_t i = 0; i < N; ++i)
+            if (PARENTS[i] != WorldNode::NO_PARENT) children[cursor[PARENTS[i]]++] = i;
+    }
+
+    // consistent: straight distance to the closest considered matchee
+    auto heuristic = [&](uint32_t i) {
+        float h{std::numeric_limits<float>::max()};
+        for (size_t m = 0; m < MATCHEES; ++m)
+            h = std::min(h, Distance(_nodes[i].Config, matchees[m].second, BOUNDING));
+        return h;
+    };
+
+    constexpr uint32_t NONE{std::numeric_limits<uint32_t>::max()};
+    std::vector<float> cost(N, std::numeric_limits<float>::max());
+    std::vector<uint32_t> previous(N, NONE);
+    std::vector<char> closed(N, 0);
+
+    using entry_t = std::pair<float, uint32_t>;
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> open;
+    for (const auto & [node, c] : SOURCES)
+    {
+        cost[node] = c;
+        open.emplace(c + heuristic(node), node);
+    }
+
+    float best{std::numeric_limits<float>::max()};
+    uint32_t best_exit{NONE};
+
+    auto relax = [&](uint32_t from, uint32_t to, uint32_t edge) {
+        if (!_edge_valid[edge]) return;
+        const float C{cost[from] + Distance(_nodes[from].Config, _nodes[to].Config, BOUNDING)};
+        if (!closed[to] && C < cost[to])
+        {
+            cost[to] = C;
+            previous[to] = from;
+            open.emplace(C + heuristic(to), to);
+        }
+    };
+
+    while (!open.empty())
+    {
+        const auto [f, node] = open.top();
+        open.pop();
+
+        if (f >= best) break;
+        if (closed[node]) continue; // outdated entry
+        closed[node] = 1;
+
+        if (auto it = exits.find(node); it != exits.end() && cost[node] + it->second.first < best)
+        {
+            best = cost[node] + it->second.first;
+            best_exit = node;
+        }
+
+        if (PARENTS[node] != WorldNode::NO_PARENT) relax(node, PARENTS[node], node);
+        for (uint32_t k = offsets[node]; k < offsets[node + 1]; ++k)
+            relax(node, children[k], children[k]);
+    }
+
+    if (best_exit == NONE) return std::nullopt;
+
+    std::vector<uint32_t> sequence;
+    for (uint32_t node = best_exit; node != NONE; node = previous[node]) sequence.emplace_back(node);
+    std::reverse(sequence.begin(), sequence.end());
+
+    RoadmapPath result;
+    result.MatcheeIndex = static_cast<int64_t>(exits[best_exit].second);
+    const Configuration & MATCHEE{matchees[result.MatcheeIndex].second};
+
+    for (uint32_t node : sequence) result.Path.emplace_back(_nodes[node].Config);
+    if (Distance(start, result.Path.front()) < 1e-10f) result.Path.erase(result.Path.begin());
+
+    // remember the validated connections
+    if (Distance(_nodes[best_exit].Config, MATCHEE) < 1e-10f)
+        result.Node = best_exit;
+    else
+    {
+        result.Path.emplace_back(MATCHEE);
+        result.Node = makeNode(MATCHEE, best_exit);
+    }
+    if (Distance(_nodes[sequence.front()].Config, start) >= 1e-10f)
+        makeNode(start, sequence.front());
+    _kdtree->insertBulk();
+
+    result.MatcheeIndex = static_cast<int64_t>(matchees[result.MatcheeIndex].first);
+    return result;
+}
+
+size_t imp::WorldTree::prune(std::unique_lock<std::mutex> & lock)
+{
+    const size_t N{size()};
+    const bool OVER_BUDGET{N > WORLD_TREE_MAX_NODES};
+    if (_compacting || (!OVER_BUDGET && _nodes.chunks().size() <= WORLD_TREE_MAX_CHUNKS))
+        return 0;
+
+    // snapshot, queries and inserts continue on the current nodes meanwhile
+    _compacting = true;
+    _edge_valid.resize(N, 1);
+    std::vector<WorldNode> snapshot{nodes()};
+    const std::vector<char> EDGE_VALID{_edge_valid};
+    const size_t POSITION{_position};
+    const uint64_t EDGE_REVISION{_edge_revision};
+    lock.unlock();
+
+    auto isRoot = [&](size_t i) { return snapshot[i].isRoot(); };
+
+    std::vector<uint32_t> children(N, 0);
+    for (const auto & node : snapshot)
+        if (!node.isRoot()) children[node.Parent]++;
+
+    std::vector<char> keep(N, 1), protect(N, 0);
+    protect[0] = 1;
+    for (size_t i = POSITION; !protect[i]; i = snapshot[i].Parent)
+    {
+        protect[i] = 1;
+        if (isRoot(i)) break;
+    }
+
+    size_t kept{N};
+    auto removable = [&](size_t i) { return keep[i] && !protect[i] && !children[i]; };
+    auto drop = [&](size_t i) {
+        keep[i] = 0;
+        --kept;
+        if (!isRoot(i)) children[snapshot[i].Parent]--;
+    };
+
+    if (OVER_BUDGET)
+    {
+        auto index{makeKDTree(snapshot)};
+
+        // redundant leaves, rating = neighbours within the cluster distances at insertion
+        const DistancePair CLUSTER{EST_POSITIONAL_CLUSTER_DISTANCE,
+                                   EST_ROTATIONAL_CLUSTER_DISTANCE};
+        for (size_t i = 0; i < N && kept > WORLD_TREE_PRUNE_TARGET; ++i)
+        {
+            if (!removable(i) || !snapshot[i].Rating) continue;
+            for (size_t j : index->within(snapshot[i].Config, CLUSTER))
+                if (j != i && keep[j])
+                {
+                    drop(i);
+                    break;
+                }
+        }
+
+        // dead-end branches, parents have lower indices so a branch is removed at once
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> leaves;
+        for (size_t i = 0; i < N; ++i)
+            if (removable(i)) leaves.push(i);
+        while (!leaves.empty() && kept > WORLD_TREE_PRUNE_TARGET)
+        {
+            const size_t I{leaves.top()};
+            leaves.pop();
+            if (!removable(I)) continue;
+            drop(I);
+            if (!isRoot(I) && removable(snapshot[I].Parent)) leaves.push(snapshot[I].Parent);
+        }
+    }
+
+    // compaction into a single chunk with global parents, dropped nodes never have kept children
+    std::vector<uint32_t> remap(N, WorldNode::NO_PARENT);
+    std::vector<WorldNode> compacted;
+    std::vector<char> edge_valid;
+    compacted.reserve(kept);
+    edge_valid.reserve(kept);
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (!keep[i]) continue;
+        remap[i] = static_cast<uint32_t>(compacted.size());
+        WorldNode node{snapshot[i]};
+        if (!isRoot(i)) node.Parent = remap[node.Parent];
+        compacted.emplace_back(node);
+        edge_valid.emplace_back(EDGE_VALID[i]);
+    }
+    snapshot.clear();
+    snapshot.shrink_to_fit();
+
+    // indices only change if nodes were dropped, the kd-tree is rebuilt before swapping
+    WorldNodes merged;
+    merged.assign(std::move(compacted));
+    std::shared_ptr<CKDTree<WorldNode, WorldNodes>> kdtree;
+    if (kept != N) kdtree = makeKDTree(merged);
+
+    lock.lock();
+    _compacting = false;
+
+    const size_t CURRENT{size()};
+    auto resolve = [&](size_t i) -> uint32_t {
+        return i < N ? remap[i] : static_cast<uint32_t>(i - N + kept);
+    };
+    _edge_valid.resize(CURRENT, 1);
+    for (size_t i = N; i < CURRENT; ++i)
+    {
+        const uint32_t PARENT{parent(i)};
+        if (PARENT != WorldNode::NO_PARENT && resolve(PARENT) == WorldNode::NO_PARENT) return 0;
+    }
+    if (resolve(_position) == WorldNode::NO_PARENT) return 0;
+
+    // edges revalidated meanwhile keep their new state
+    if (_edge_revision != EDGE_REVISION)
+    {
+        for (size_t i = 0; i < N; ++i)
+            if (keep[i]) edge_valid[remap[i]] = _edge_valid[i];
+    }
+
+    // nodes appended meanwhile (roadmap connections, moves, joins) follow the merged ones
+    for (size_t i = N; i < CURRENT; ++i)
+    {
+        WorldNode node{_nodes[i]};
+        const uint32_t PARENT{parent(i)};
+        node.Parent = PARENT == WorldNode::NO_PARENT ? PARENT : resolve(PARENT);
+        merged.emplace_back(node);
+        edge_valid.emplace_back(_edge_valid[i]);
+    }
+
+    // ratings the merged nodes gained meanwhile are not carried over
+    _position = resolve(_position);
+    _nodes = std::move(merged);
+    _edge_valid.swap(edge_valid);
+    if (kept != N)
+    {
+        _edge_indexed = 0;
+        _kdtree = std::move(kdtree);
+    }
+    _kdtree->rebind(_nodes);
+    _kdtree->insertBulk();
+    return N - kept;
+}
+
+std::vector<uint32_t> imp::WorldTree::parents() const
+{
+    std::vector<uint32_t> result;
+    result.reserve(size());
+    for (const auto & chunk : _nodes.chunks())
+    {
+        for (const auto & node : chunk.Data)
+            result.emplace_back(node.isRoot() ? chunk.Meta.Attach
+                                              : node.Parent + chunk.Meta.ParentOffset);
+    }
+    return result;
+}
+
+std::vector<imp::WorldNode> imp::WorldTree::nodes() const
+{
+    std::vector<WorldNode> result;
+    result.reserve(size());
+    for (const auto & chunk : _nodes.chunks())
+    {
+        for (WorldNode node : chunk.Data)
+        {
+            if (node.isRoot())
+                node.Parent = chunk.Meta.Attach;
+            else
+                node.Parent += chunk.Meta.ParentOffset;
+            result.emplace_back(node);
+        }
+    }
+    return result;
+}
+
+fcl::AABBf imp::WorldTree::edgeBox(size_t edge, float radius) const
+{
+    const Pose & A{_nodes[edge].Config};
+    const Pose & B{_nodes[parent(edge)].Config};
+
+    fcl::Vector3f min, max;
+    for (size_t k = 0; k < 3; ++k)
+    {
+        min[k] = std::min(A[k], B[k]) - radius;
+        max[k] = std::max(A[k], B[k]) + radius;
+    }
+    return fcl::AABBf(min, max);
+}
+
+size_t imp::WorldTree::revalidateEdges(ObjectManager & manager, const fcl::AABBf & box,
+                                       bool added)
+{
+    std::lock_guard<std::mutex> guard(_edit_mtx);
+
+    const size_t N{size()};
+    if (N < 2) return 0;
+    _edge_valid.resize(N, 1);
+
+    const float RADIUS{manager.sweepRadius(_MOVABLE_ID)};
+    const std::vector<uint32_t> PARENTS{parents()};
+
+    // the index is rebuilt once the linearly scanned tail grows too long
+    if (_edge_indexed > N ||
+        static_cast<float>(N - _edge_indexed) > WORLD_TREE_EDGE_INDEX_MAX_TAIL * N)
+    {
+        std::vector<std::pair<uint32_t, fcl::AABBf>> edges;
+        edges.reserve(N);
+        for (size_t i = 0; i < N; ++i)
+            if (PARENTS[i] != WorldNode::NO_PARENT)
+                edges.emplace_back(static_cast<uint32_t>(i), edgeBox(i, RADIUS));
+        _edge_index.build(std::move(edges));
+        _edge_indexed = N;
+    }
+
+    std::vector<uint32_t> edges{_edge_index.overlapping(box)};
+    for (size_t i = _edge_indexed; i < N; ++i)
+        if (PARENTS[i] != WorldNode::NO_PARENT && edgeBox(i, RADIUS).overlap(box))
+            edges.emplace_back(static_cast<uint32_t>(i));
+
+    // an added object can only invalidate, a removed one only validate edges
+    std::erase_if(edges, [&](uint32_t i) { return bool(_edge_valid[i]) != added; });
+
+    std::vector<char> valid(edges.size());
+#pragma omp parallel for
+    for (int64_t k = 0; k < static_cast<int64_t>(edges.size()); ++k)
+    {
+        valid[k] = manager.isCollisionFreePath(_MOVABLE_ID, _nodes[edges[k]].Config,
+                                               _nodes[PARENTS[edges[k]]].Config);
+    }
+
+    size_t changed{0};
+    for (size_t k = 0; k < edges.size(); ++k)
+    {
+        changed += valid[k] != _edge_valid[edges[k]];
+        _edge_valid[edges[k]] = valid[k];
+    }
+    if (changed) _edge_revision++;
+    return changed;
 }
\ No newline at end of file
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include <fcl/fcl.h>
 
 #include "CKDTree.hpp"
+#include "ChunkedVector.hpp"
+#include "EdgeBVH.hpp"
 #include "ObjectManager.hpp"
 #include "ESTNode.hpp"
+#include "Settings.hpp"
 #include "json/JSON.hpp"
 
 namespace imp
@@ -14,14 +19,44 @@ namespace imp
 
 using WorldNode = ESTNode;
 
+/**
+ * @brief Link of a chunk of WorldTree nodes to the rest of the tree. Parents are stored relative
+ * to ParentOffset, the chunk roots (NO_PARENT) are attached to Attach. Allows to adopt the node
+ * buffer of an EST without touching its nodes.
+ */
+struct WorldChunkLink
+{
+    uint32_t ParentOffset{0};
+    uint32_t Attach{WorldNode::NO_PARENT};
+};
+
+using WorldNodes = ChunkedVector<WorldNode, WorldChunkLink>;
+
 class EST;
 
+namespace io
+{
+class Snapshot;
+}
+
+/**
+ * @brief Answer of a roadmap query.
+ */
+struct RoadmapPath
+{
+    int64_t MatcheeIndex{-1};        // u path index of the reached matchee
+    std::vector<Configuration> Path; // excluding the start, ending at the matchee
+    size_t Node{0};                  // world tree node of the reached matchee
+};
+
 class WorldTree : public json::JSONable
 {
+    friend io::Snapshot;
+
     // data
 private:
-    std::vector<WorldNode> _nodes;
-    std::shared_ptr<CKDTree<WorldNode>> _kdtree{nullptr};
+    WorldNodes _nodes; // one chunk per joined EST, merged by prune
+    std::shared_ptr<CKDTree<WorldNode, WorldNodes>> _kdtree{nullptr};
 
     const size_t _MOVABLE_ID{0};
 
@@ -30,10 +65,47 @@ private:
     size_t _position{0};                    // "current" position of the object
     std::vector<size_t> _position_children; // todo: validation function
 
+    // edge i connects node i and its parent, edges created later are valid by construction
+    std::vector<char> _edge_valid;
+    EdgeBVH _edge_index; // swept boxes of the edges [1, _edge_indexed)
+    size_t _edge_indexed{0};
+    uint64_t _edge_revision{0}; // counts revalidations that changed an edge
+
+    bool _compacting{false}; // prune works on a snapshot, at most one at a time
+
     // properties
 public:
     size_t size() const noexcept { return _nodes.size(); }
 
+    /**
+     * @brief Parent of node i (WorldNode::NO_PARENT for the root), resolves the chunk links.
+     */
+    uint32_t parent(size_t i) const
+    {
+        const auto & chunk{_nodes.chunkOf(i)};
+        const WorldNode & NODE{chunk.Data[i - chunk.Base]};
+        return NODE.isRoot() ? chunk.Meta.Attach : NODE.Parent + chunk.Meta.ParentOffset;
+    }
+
+    /**
+     * @brief Parents of all nodes, cheaper than calling parent for each node.
+     */
+    std::vector<uint32_t> parents() const;
+
+    /**
+     * @brief Copy of all nodes with resolved parents.
+     */
+    std::vector<WorldNode> nodes() const;
+
+    /**
+     * @brief Approximate number of bytes held by the nodes and the kd-tree.
+     */
+    size_t memoryUsage()
+    {
+        std::lock_guard<std::mutex> guard(_edit_mtx);
+        return _nodes.capacity() * sizeof(WorldNode) + _kdtree->memoryUsage();
+    }
+
     bool initialize(Configuration root)
     {
         if (size())
@@ -64,43 +136,135 @@ public:
     void moveToInsert(const Configuration & end)
     {
         _position = makeNode(end, _position);
+        _kdtree->insertBulk();
     }
 
-    bool join(imp::EST & est);
+    /**
+     * @brief Adopts the nodes of a finished exploration rooted at the current position. The
+     * node buffer is moved in without copying nodes, the tree lock is held for appending the
+     * edge flags (O(exploration size)) and for the snapshot taken by prune (O(tree size), every
+     * WORLD_TREE_MAX_CHUNKS joins).
+     *
+     * @param follow Whether the current position moves to the solution of the exploration
+     * (false for explorations that only grow the roadmap).
+     */
+    bool join(imp::EST & est, bool follow = true);
+
+    /**
+     * @brief Configuration of the current position, std::nullopt for an empty tree.
+     */
+    std::optional<Configuration> position()
+    {
+        std::lock_guard<std::mutex> guard(_edit_mtx);
+        if (!size()) return std::nullopt;
+        return Configuration(_nodes[_position].Config);
+    }
+
+    /**
+     * @brief Configuration of the node at the relative index u in [0, 1).
+     */
+    std::optional<Configuration> sample(float u)
+    {
+        std::lock_guard<std::mutex> guard(_edit_mtx);
+        if (!size()) return std::nullopt;
+        return Configuration(_nodes[std::min(size() - 1, static_cast<size_t>(u * size()))].Config);
+    }
+
+    /**
+     * @brief Sets the "current" position to an existing node (e.g. after a roadmap path has
+     * been executed).
+     */
+    void moveTo(size_t node)
+    {
+        std::lock_guard<std::mutex> guard(_edit_mtx);
+        if (node < size()) _position = node;
+    }
+
+    /**
+     * @brief Tries to answer a path query from the explored roadmap. Start and matchees are
+     * connected to nearby nodes by validated edges, then A* runs over the tree edges.
+     * Successful connections are inserted into the tree.
+     *
+     * @return The cheapest path to one of the matchees or std::nullopt on a miss.
+     */
+    std::optional<RoadmapPath>
+    roadmap(ObjectManager & manager, const Configuration & start,
+            const std::vector<std::pair<size_t, Configuration>> & matchees);
+
+    /**
+     * @brief Rechecks the edges whose swept box (inflated by the movable's bounding sphere)
+     * overlaps box. After a static object was added only valid edges are checked, after a
+     * removal only invalid ones. Invalid edges are skipped by roadmap queries.
+     *
+     * @return Number of edges that changed their state.
+     */
+    size_t revalidateEdges(ObjectManager & manager, const fcl::AABBf & box, bool added);
 
     // constructors etc.
 public:
     WorldTree(const size_t MOVABLE_ID)
         : _MOVABLE_ID{MOVABLE_ID}
     {
-        CKDTreeBox world_domain(fcl::Vector3f{std::numeric_limits<float>::lowest(),
-                                              std::numeric_limits<float>::lowest(),
-                                              std::numeric_limits<float>::lowest()},
-                                fcl::Quaternionf{-1.0f, -1.0f, -1.0f, -1.0f},
-                                fcl::Vector3f{std::numeric_limits<float>::max(),
-                                              std::numeric_limits<float>::max(),
-                                              std::numeric_limits<float>::max()},
-                                fcl::Quaternionf{1.0f, 1.0f, 1.0f, 1.0f});
-        _kdtree = // ! irrelevant rating
-            std::make_shared<CKDTree<WorldNode>>(_nodes, world_domain, std::make_pair(1.0f, 1.0f));
+        resetKDTree();
     }
 
     // methods
 private:
+    /**
+     * @brief Indexes the nodes at once (rating = local density), the stored ratings are kept.
+     */
+    template <class container_t>
+    static std::shared_ptr<CKDTree<WorldNode, container_t>> makeKDTree(container_t & nodes)
+    {
+        // finite domain, infinite extents break the split direction selection
+        CKDTreeBox world_domain(fcl::Vector3f{-WORLD_TREE_DOMAIN_EXTENT, //
+                                              -WORLD_TREE_DOMAIN_EXTENT, //
+                                              -WORLD_TREE_DOMAIN_EXTENT},
+                                fcl::Quaternionf{-1.0f, -1.0f, -1.0f, -1.0f},
+                                fcl::Vector3f{WORLD_TREE_DOMAIN_EXTENT, //
+                                              WORLD_TREE_DOMAIN_EXTENT, //
+                                              WORLD_TREE_DOMAIN_EXTENT},
+                                fcl::Quaternionf{1.0f, 1.0f, 1.0f, 1.0f});
+        auto kdtree{std::make_shared<CKDTree<WorldNode, container_t>>(
+            nodes, world_domain,
+            std::make_pair(EST_POSITIONAL_CLUSTER_DISTANCE, EST_ROTATIONAL_CLUSTER_DISTANCE),
+            1024, false)};
+        kdtree->insertBulk();
+        return kdtree;
+    }
+
+    void resetKDTree() { _kdtree = makeKDTree(_nodes); }
+
+    /**
+     * @brief Enforces WORLD_TREE_MAX_NODES (caller holds _edit_mtx through lock). Leaves with a
+     * neighbour within the cluster distances are dropped first, then dead-end branches (oldest
+     * first) until WORLD_TREE_PRUNE_TARGET is reached. The root, the current position and its
+     * ancestors are kept. Compacts the nodes into a single chunk (also done once there are more
+     * than WORLD_TREE_MAX_CHUNKS chunks) and rebuilds the kd-tree if nodes were dropped.
+     *
+     * The snapshot (nodes and edge flags) is copied under the lock, which is then released while
+     * the snapshot is compacted and indexed, the result is swapped in afterwards. Nodes appended meanwhile are carried over, the compaction is
+     * discarded if one of them (or the current position) refers to a dropped node.
+     *
+     * @return number of removed nodes
+     */
+    size_t prune(std::unique_lock<std::mutex> & lock);
+
+    fcl::AABBf edgeBox(size_t edge, float radius) const;
+
     size_t makeNode(const Configuration & c, size_t parent = 0)
     {
         WorldNode node;
         node.Config = c;
         node.Rating = 0;
-        node.IsRoot = !size();
-        node.Parent = parent;
+        node.Parent = size() ? static_cast<uint32_t>(parent) : WorldNode::NO_PARENT;
         _nodes.emplace_back(node);
         return size() - 1;
     }
 
 public:
     JSON_IMPL(
-        auto & Nodes{_nodes}; 
+        auto Nodes{nodes()}; 
         auto & KDTree{_kdtree}; 
         auto & Position{_position}; 
         JSOND(Nodes) JSOND(KDTree) JSON(Position)
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace imp::io
+{
+
+/**
+ * @brief Appends trivially copyable values and arrays of them to a byte buffer. Values are
+ * stored in native byte order (little-endian on all supported platforms), arrays are prefixed
+ * with their element count as uint64_t.
+ */
+class BinaryWriter
+{
+    /////////
+    // data
+    /////////
+private:
+    std::vector<char> _buffer;
+
+    /////////
+    // methods
+    /////////
+public:
+    inline void append(const void * data, const size_t SIZE)
+    {
+        const size_t OFFSET{_buffer.size()};
+        _buffer.resize(OFFSET + SIZE);
+        if (SIZE) std::memcpy(_buffer.data() + OFFSET, data, SIZE);
+    }
+
+    template <class value_t>
+    requires std::is_trivially_copyable_v<value_t>
+    inline void write(const value_t & value) { append(&value, sizeof(value_t)); }
+
+    template <class value_t>
+    requires std::is_trivially_copyable_v<value_t>
+    inline void write(const value_t * values, const size_t COUNT)
+    {
+        write<uint64_t>(COUNT);
+        append(values, COUNT * sizeof(value_t));
+    }
+
+    template <class value_t>
+    requires std::is_trivially_copyable_v<value_t>
+    inline void write(const std::vector<value_t> & values) { write(values.data(), values.size()); }
+
+    inline void write(const std::string & value) { write(value.data(), value.size()); }
+
+    inline size_t size() const noexcept { return _buffer.size(); }
+    inline const std::vector<char> & buffer() const noexcept { return _buffer; }
+    inline std::vector<char> release() { return std::move(_buffer); }
+};
+
+/**
+ * @brief Reads values written by BinaryWriter from a (possibly memory mapped) byte range
+ * without taking ownership. All reads are bounds checked, a failed read marks the reader as
+ * not good and leaves the target untouched.
+ */
+class BinaryReader
+{
+    /////////
+    // data
+    /////////
+private:
+    const char * _data{nullptr};
+    size_t _size{0};
+    size_t _offset{0};
+    bool _good{true};
+
+    /////////
+    // constructors
+    /////////
+public:
+    BinaryReader(const char * data, const size_t SIZE) : _data{data}, _size{SIZE} {}
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Returns a pointer to the next SIZE bytes and skips them, nullptr if out of range.
+     */
+    inline const char * view(const size_t SIZE)
+    {
+        if (!_good || SIZE > _size - _offset)
+        {
+            _good = false;
+            return nullptr;
+        }
+        const char * result{_data + _offset};
+        _offset += SIZE;
+        return result;
+    }
+
+    template <class value_t>
+    requires std::is_trivially_copyable_v<value_t>
+    inline bool read(value_t & value)
+    {
+        const char * data{view(sizeof(value_t))};
+        if (data) std::memcpy(&value, data, sizeof(value_t));
+        return data;
+    }
+
+    /**
+     * @brief Returns a pointer to the next length prefixed array and its element count without
+     * copying. The pointer may be unaligned, copy elements out with std::memcpy.
+     */
+    template <class value_t>
+    requires std::is_trivially_copyable_v<value_t>
+    inline std::pair<const char *, size_t> viewArray()
+    {
+        uint64_t count{0};
+        if (!read(count) || count > (_size - _offset) / sizeof(value_t))
+        {
+            _good = false;
+            return std::make_pair(nullptr, size_t(0));
+        }
+        return std::make_pair(view(count * sizeof(value_t)), static_cast<size_t>(count));
+    }
+
+    template <class value_t>
+    requires std::is_trivially_copyable_v<value_t>
+    inline bool read(std::vector<value_t> & values)
+    {
+        auto [data, count] = viewArray<value_t>();
+        if (!data) return false;
+        values.resize(count);
+        if (count) std::memcpy(values.data(), data, count * sizeof(value_t));
+        return true;
+    }
+
+    inline bool read(std::string & value)
+    {
+        auto [data, count] = viewArray<char>();
+        if (!data) return false;
+        value.assign(data, count);
+        return true;
+    }
+
+    inline bool good() const noexcept { return _good; }
+    inline size_t offset() const noexcept { return _offset; }
+    inline size_t remaining() const noexcept { return _size - _offset; }
+};
+
+} // namespace imp::io
@@ -0,0 +1,115 @@
+#include "imp/io/ESTDumper.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "imp/io/Binary.hpp"
+
+imp::io::ESTDumper::ESTDumper() : _writer{&ESTDumper::run, this} {}
+
+imp::io::ESTDumper::~ESTDumper()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _running = false;
+    }
+    _condition.notify_all();
+    _writer.join();
+}
+
+imp::io::ESTDumper & imp::io::ESTDumper::get()
+{
+    static ESTDumper instance;
+    return instance;
+}
+
+bool imp::io::ESTDumper::sample()
+{
+    if constexpr (EST_DUMP_SAMPLING_INTERVAL == 0)
+        return false;
+    else
+        return _enabled && _sample_counter++ % EST_DUMP_SAMPLING_INTERVAL == 0;
+}
+
+bool imp::io::ESTDumper::push(ESTDump && dump)
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (_pending.size() >= EST_DUMP_MAX_PENDING || _accepted >= EST_DUMP_MAX_FILES)
+        {
+            _dropped++;
+            return false;
+        }
+        _accepted++;
+        _pending.emplace_back(std::move(dump));
+    }
+    _condition.notify_one();
+    return true;
+}
+
+void imp::io::ESTDumper::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _condition.wait(lock, [this]() { return !_running || !_pending.empty(); });
+        if (_pending.empty()) return; // only stopped once everything is written
+
+        ESTDump dump{std::move(_pending.front())};
+        _pending.pop_front();
+
+        lock.unlock();
+        write(dump);
+        lock.lock();
+    }
+}
+
+void imp::io::ESTDumper::write(const ESTDump & dump)
+{
+    BinaryWriter writer;
+    writer.append(MAGIC, sizeof(MAGIC));
+    writer.write(VERSION);
+    writer.write(dump.Session);
+    writer.write(dump.Exploration);
+    writer.write(dump.Matchee);
+    writer.write<uint8_t>(dump.CompleteSolution);
+    writer.write(dump.SolutionIndex);
+
+    writer.write<uint64_t>(dump.Statistics.Iterations);
+    writer.write<uint64_t>(dump.Statistics.Candidates);
+    writer.write<uint64_t>(dump.Statistics.Accepted);
+    writer.write(dump.Statistics.Seconds);
+    writer.write(dump.Statistics.NodesPerSecond);
+
+    writer.write(dump.Nodes);
+
+    static_assert(sizeof(fcl::Vector3f) == 3 * sizeof(float));
+    writer.write<uint64_t>(dump.Objects.size());
+    std::vector<uint32_t> indices;
+    for (const auto & object : dump.Objects)
+    {
+        const auto & model{*object.Model};
+        writer.write(Pose(object.Transform));
+
+        writer.write<uint64_t>(model.num_vertices);
+        writer.append(model.vertices, model.num_vertices * sizeof(fcl::Vector3f));
+
+        indices.resize(3 * model.num_tris);
+        for (size_t t = 0; t < model.num_tris; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+                indices[3 * t + k] = static_cast<uint32_t>(model.tri_indices[t][k]);
+        }
+        writer.write(indices);
+    }
+
+    std::stringstream fn;
+    fn << "est-" << dump.Session << "-" << dump.Exploration << ".bin";
+
+    std::error_code error;
+    std::filesystem::create_directories(EST_DUMP_DIRECTORY, error);
+    std::ofstream out(std::filesystem::path(EST_DUMP_DIRECTORY) / fn.str(),
+                      std::ios::out | std::ios::binary);
+    out.write(writer.buffer().data(), writer.size());
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "imp/EST.hpp"
+#include "imp/ESTNode.hpp"
+#include "imp/ObjectManager.hpp"
+#include "imp/Settings.hpp"
+
+namespace imp::io
+{
+
+/**
+ * @brief Snapshot of a finished exploration. Nodes are copied in bulk, the static objects are
+ * shared with the ObjectManager (their models are immutable once built).
+ */
+struct ESTDump
+{
+    uint64_t Session{0};
+    uint64_t Exploration{0};
+    Pose Matchee;
+    uint32_t SolutionIndex{0};
+    bool CompleteSolution{false};
+    ESTStatistics Statistics;
+    std::vector<ESTNode> Nodes;
+    std::vector<ObjectManager::StaticObject> Objects;
+};
+
+/**
+ * @brief Writes sampled EST dumps in a compact binary format on a background thread, so dumping
+ * stays off the latency path of a request. Use ESTDumper::get() for the process wide instance.
+ * Dumps are written to EST_DUMP_DIRECTORY, at most EST_DUMP_MAX_FILES per process.
+ *
+ * File layout (native byte order): "IMPE", uint32 version, uint64 session, uint64 exploration,
+ * Pose matchee, uint8 complete, uint32 solution index, statistics (3 x uint64, 2 x float),
+ * ESTNode array, uint64 object count and per object: Pose transform, Vector3f array and
+ * uint32 triangle index array. Arrays are prefixed by their uint64 element count.
+ */
+class ESTDumper
+{
+    /////////
+    // data
+    /////////
+private:
+    static constexpr char MAGIC[4]{'I', 'M', 'P', 'E'};
+    static constexpr uint32_t VERSION{1};
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<ESTDump> _pending;
+    bool _running{true};
+
+    std::atomic<bool> _enabled{true};
+    std::atomic<size_t> _sample_counter{0};
+    std::atomic<size_t> _dropped{0};
+    size_t _accepted{0}; // pending or written, guarded by _mutex
+
+    std::thread _writer;
+
+    /////////
+    // constructors
+    /////////
+public:
+    ESTDumper();
+    ~ESTDumper();
+
+    ESTDumper(const ESTDumper &) = delete;
+    ESTDumper & operator=(const ESTDumper &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    static ESTDumper & get();
+
+    /**
+     * @brief Decides whether the current exploration is dumped (every
+     * EST_DUMP_SAMPLING_INTERVAL-th one while enabled).
+     */
+    bool sample();
+
+    /**
+     * @brief Switches dumping on or off at runtime (e.g. off for benchmark runs), on by default.
+     */
+    inline void setEnabled(const bool ENABLED) { _enabled = ENABLED; }
+
+    /**
+     * @brief Hands the dump to the writer thread. Never blocks on I/O, the dump is dropped if
+     * EST_DUMP_MAX_PENDING dumps are already waiting or EST_DUMP_MAX_FILES were accepted.
+     */
+    bool push(ESTDump && dump);
+
+    inline size_t dropped() const noexcept { return _dropped; }
+
+private:
+    void run();
+
+    static void write(const ESTDump & dump);
+};
+
+} // namespace imp::io
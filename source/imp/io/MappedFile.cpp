@@ -0,0 +1,49 @@
+#include "imp/io/MappedFile.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+imp::io::MappedFile::MappedFile(const std::string & filename)
+{
+#ifndef _WIN32
+    const int FD{::open(filename.c_str(), O_RDONLY)};
+    if (FD < 0) return;
+
+    struct stat info;
+    if (::fstat(FD, &info) == 0 && info.st_size > 0)
+    {
+        void * data{::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, FD, 0)};
+        if (data != MAP_FAILED)
+        {
+            _data = static_cast<const char *>(data);
+            _size = static_cast<size_t>(info.st_size);
+            _mapped = true;
+        }
+    }
+    ::close(FD); // the mapping stays valid
+#else
+    std::ifstream in(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in) return;
+
+    _fallback.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!_fallback.empty() && in.read(_fallback.data(), _fallback.size()))
+    {
+        _data = _fallback.data();
+        _size = _fallback.size();
+    }
+#endif
+}
+
+imp::io::MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (_mapped) ::munmap(const_cast<char *>(_data), _size);
+#endif
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace imp::io
+{
+
+/**
+ * @brief Read only view of a whole file. Uses mmap on POSIX systems, so pages are only loaded
+ * when they are touched, and falls back to reading the file into memory elsewhere.
+ */
+class MappedFile
+{
+    /////////
+    // data
+    /////////
+private:
+    const char * _data{nullptr};
+    size_t _size{0};
+    bool _mapped{false};
+    std::vector<char> _fallback;
+
+    /////////
+    // constructors
+    /////////
+public:
+    MappedFile(const std::string & filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    /////////
+    // properties
+    /////////
+public:
+    inline bool good() const noexcept { return _data != nullptr; }
+    inline const char * data() const noexcept { return _data; }
+    inline size_t size() const noexcept { return _size; }
+};
+
+} // namespace imp::io
@@ -0,0 +1,123 @@
+#include "imp/io/RequestLog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#include "imp/io/MappedFile.hpp"
+
+imp::io::RequestLog::Entry::~Entry()
+{
+    RequestLog::get().append(_TYPE, _timer.elapsed(), _payload.buffer());
+}
+
+imp::io::RequestLog::RequestLog()
+{
+    // records are only appended behind complete ones, anything else is cut off or moved aside
+    std::vector<Record> records;
+    std::error_code error;
+    const std::filesystem::path PATH{REQUEST_LOG_FILENAME};
+    if (const auto SIZE{std::filesystem::file_size(PATH, error)}; !error && SIZE)
+    {
+        size_t complete{0};
+        if (!read(REQUEST_LOG_FILENAME, records, &complete))
+        {
+            if (!complete)
+            {
+                std::filesystem::path old{PATH};
+                old += ".old";
+                std::filesystem::rename(PATH, old, error);
+                _message = "not a request log, moved to " + old.string();
+            }
+            else
+            {
+                std::filesystem::resize_file(PATH, complete, error);
+                _message = "cut off a torn record at byte " + std::to_string(complete);
+            }
+            if (error)
+            {
+                _message = "unable to recover " + PATH.string() + ": " + error.message();
+                return;
+            }
+        }
+    }
+
+    _file.open(REQUEST_LOG_FILENAME, std::ios::out | std::ios::binary | std::ios::app);
+    if (!_file)
+    {
+        _message = "unable to open " + PATH.string();
+        return;
+    }
+
+    // a new log starts with the header, an existing one is continued after its last request
+    _file.seekp(0, std::ios::end);
+    if (_file.tellp() == 0)
+    {
+        _file.write(MAGIC, sizeof(MAGIC));
+        _file.write(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION));
+        return;
+    }
+
+    for (const auto & record : records)
+        _offset = std::max(_offset, record.Timestamp + record.Duration);
+}
+
+imp::io::RequestLog & imp::io::RequestLog::get()
+{
+    static RequestLog instance;
+    return instance;
+}
+
+void imp::io::RequestLog::append(const Type TYPE, const time::duration_t & duration,
+                                 const std::vector<char> & payload)
+{
+    using namespace std::chrono;
+
+    BinaryWriter writer;
+    writer.write(TYPE);
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (!_file) return;
+
+        const uint64_t END{static_cast<uint64_t>(
+            duration_cast<nanoseconds>(_opened.elapsed()).count())};
+        const uint64_t DURATION{
+            std::min(END, static_cast<uint64_t>(duration_cast<nanoseconds>(duration).count()))};
+        writer.write<uint64_t>(_offset + END - DURATION);
+        writer.write<uint64_t>(REQUEST_LOG_TIMING ? DURATION : 0);
+        writer.write(payload);
+
+        // whole records only, the log stays readable if the process is killed between them
+        _file.write(writer.buffer().data(), static_cast<std::streamsize>(writer.size()));
+        _file.flush();
+    }
+}
+
+bool imp::io::RequestLog::read(const std::string & filename, std::vector<Record> & records,
+                               size_t * complete)
+{
+    if (complete) *complete = 0;
+    MappedFile file(filename);
+    if (!file.good()) return false;
+
+    BinaryReader reader(file.data(), file.size());
+    const char * magic{reader.view(sizeof(MAGIC))};
+    uint32_t version{0};
+    if (!magic || std::memcmp(magic, MAGIC, sizeof(MAGIC)) || !reader.read(version) ||
+        version != VERSION)
+        return false;
+
+    records.clear();
+    while (true)
+    {
+        if (complete) *complete = reader.offset();
+        if (!reader.remaining()) return true;
+
+        Record record;
+        if (!reader.read(record.RecordType) || !reader.read(record.Timestamp) ||
+            !reader.read(record.Duration) || !reader.read(record.Payload))
+            return false;
+        records.emplace_back(std::move(record));
+    }
+}
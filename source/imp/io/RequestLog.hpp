@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "imp/Settings.hpp"
+#include "imp/io/Binary.hpp"
+#include "imp/time/Timer.hpp"
+
+namespace imp::io
+{
+
+/**
+ * @brief Append-only binary log of the scene and query requests (RECORD_REQUESTS), replayed by
+ * imp-replay (directly) or tools/replay.py (over HTTP). Use RequestLog::get() for the process
+ * wide instance writing REQUEST_LOG_FILENAME. An existing log is continued, a torn tail is cut
+ * off first. A file that is not a request log of this version is moved to
+ * REQUEST_LOG_FILENAME.old and a new log is started.
+ *
+ * File layout (native byte order): "IMPR", uint32 version, then per record: uint8 type,
+ * uint64 timestamp (ns, start of the request since the log was created), uint64 duration (ns,
+ * 0 if REQUEST_LOG_TIMING is off), uint64 payload size and the payload. Records are appended
+ * once a request completes (a path-to when its result is taken), replays order them by their
+ * timestamp. Payloads use the bodies of the binary endpoints (see server::BinaryCodec, without
+ * header):
+ *  Clear         -
+ *  Create        /create-bin body, uint64 created id
+ *  Remove        uint8 array movable, uint64 array ids
+ *  Collides      /collides-any-bin body (a single pose)
+ *  CollidesAny   /collides-any-bin body
+ *  PathTo        /path-to-bin body
+ *  Moved         int32 movable id, start pose, end pose
+ */
+class RequestLog
+{
+    /////////
+    // nested
+    /////////
+public:
+    enum class Type : uint8_t
+    {
+        Clear,
+        Create,
+        Remove,
+        Collides,
+        CollidesAny,
+        PathTo,
+        Moved
+    };
+
+    struct Record
+    {
+        Type RecordType{Type::Clear};
+        uint64_t Timestamp{0};
+        uint64_t Duration{0};
+        std::vector<char> Payload;
+    };
+
+    /**
+     * @brief Collects the payload of a request and appends the record on destruction, together
+     * with the time since construction.
+     */
+    class Entry
+    {
+        /////////
+        // data
+        /////////
+    private:
+        const Type _TYPE;
+        time::Timer _timer;
+        BinaryWriter _payload;
+
+        /////////
+        // constructors
+        /////////
+    public:
+        explicit Entry(const Type TYPE) : _TYPE{TYPE} {}
+        ~Entry();
+
+        Entry(const Entry &) = delete;
+        Entry & operator=(const Entry &) = delete;
+
+        /////////
+        // methods
+        /////////
+    public:
+        inline BinaryWriter & payload() { return _payload; }
+    };
+
+    /////////
+    // data
+    /////////
+private:
+    static constexpr char MAGIC[4]{'I', 'M', 'P', 'R'};
+    static constexpr uint32_t VERSION{1};
+
+    std::mutex _mutex;
+    std::ofstream _file;
+    time::Timer _opened;
+    uint64_t _offset{0}; // end of the continued log (ns)
+    std::string _message; // see message()
+
+    /////////
+    // constructors
+    /////////
+public:
+    RequestLog();
+
+    RequestLog(const RequestLog &) = delete;
+    RequestLog & operator=(const RequestLog &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    static RequestLog & get();
+
+    inline bool good() const { return bool(_file); }
+
+    /**
+     * @brief What happened to an existing file on opening (cut off, moved aside) or why it
+     * could not be opened, empty otherwise. Logged by the server.
+     */
+    inline const std::string & message() const { return _message; }
+
+    /**
+     * @brief Appends a request that completed now and took the given duration.
+     */
+    void append(const Type TYPE, const time::duration_t & duration,
+                const std::vector<char> & payload);
+
+    /**
+     * @brief Reads all records of a log, false if the file is not a (complete) request log.
+     *
+     * @param complete Receives the size of the header and the complete records in bytes (0 if
+     * the file is not a request log).
+     */
+    static bool read(const std::string & filename, std::vector<Record> & records,
+                     size_t * complete = nullptr);
+};
+
+} // namespace imp::io
@@ -0,0 +1,236 @@
+#include "imp/io/Snapshot.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "imp/EST.hpp"
+#include "imp/WorldTree.hpp"
+#include "imp/io/Binary.hpp"
+#include "imp/io/MappedFile.hpp"
+
+namespace
+{
+
+static_assert(sizeof(fcl::Vector3f) == 3 * sizeof(float));
+
+struct MeshView
+{
+    const char * Vertices{nullptr};
+    size_t NumVertices{0};
+    const char * Indices{nullptr};
+    size_t NumIndices{0};
+};
+
+struct SlotView
+{
+    bool Used{false};
+    MeshView Mesh;
+    imp::Pose Transform;
+    uint64_t Position{0};
+    std::vector<imp::WorldNode> Nodes;
+    std::vector<char> EdgeValid;
+};
+
+void writeMesh(imp::io::BinaryWriter & writer, const fcl::BVHModel<fcl::OBBf> & model)
+{
+    writer.write<uint64_t>(model.num_vertices);
+    writer.append(model.vertices, model.num_vertices * sizeof(fcl::Vector3f));
+
+    std::vector<uint32_t> indices(3 * model.num_tris);
+    for (size_t t = 0; t < model.num_tris; ++t)
+    {
+        for (size_t k = 0; k < 3; ++k)
+            indices[3 * t + k] = static_cast<uint32_t>(model.tri_indices[t][k]);
+    }
+    writer.write(indices);
+}
+
+bool readMesh(imp::io::BinaryReader & reader, MeshView & mesh)
+{
+    uint64_t count{0};
+    if (!reader.read(count) || count > reader.remaining() / sizeof(fcl::Vector3f)) return false;
+    mesh.NumVertices = static_cast<size_t>(count);
+    mesh.Vertices = reader.view(mesh.NumVertices * sizeof(fcl::Vector3f));
+
+    std::tie(mesh.Indices, mesh.NumIndices) = reader.viewArray<uint32_t>();
+    return reader.good() && mesh.NumIndices % 3 == 0;
+}
+
+std::shared_ptr<fcl::BVHModel<fcl::OBBf>> buildMesh(imp::MeshRegistry & meshes,
+                                                    const MeshView & mesh)
+{
+    std::vector<fcl::Vector3f> vertices(mesh.NumVertices);
+    if (mesh.NumVertices)
+        std::memcpy(vertices.data(), mesh.Vertices, mesh.NumVertices * sizeof(fcl::Vector3f));
+
+    std::vector<fcl::Triangle> triangles(mesh.NumIndices / 3);
+    for (size_t t = 0; t < triangles.size(); ++t)
+    {
+        uint32_t index[3];
+        std::memcpy(index, mesh.Indices + 3 * t * sizeof(uint32_t), sizeof(index));
+        for (size_t k = 0; k < 3; ++k)
+        {
+            if (index[k] >= mesh.NumVertices) return nullptr;
+            triangles[t][k] = static_cast<size_t>(index[k]);
+        }
+    }
+
+    return meshes.acquire(vertices, triangles);
+}
+
+bool buildMeshes(imp::MeshRegistry & meshes, std::vector<SlotView> & slots,
+                 std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBf>>> & models)
+{
+    models.assign(slots.size(), nullptr);
+    int failed{0};
+#pragma omp parallel for reduction(+ : failed)
+    for (int64_t i = 0; i < static_cast<int64_t>(slots.size()); ++i)
+    {
+        if (!slots[i].Used) continue;
+        models[i] = buildMesh(meshes, slots[i].Mesh);
+        failed += !models[i];
+    }
+    return !failed;
+}
+
+} // namespace
+
+bool imp::io::Snapshot::save(ObjectManager & manager, const std::string & filename)
+{
+    BinaryWriter writer;
+    writer.append(MAGIC, sizeof(MAGIC));
+    writer.write(VERSION);
+
+    {
+        std::lock_guard<std::mutex> guard(manager._static_mutex);
+        writer.write<uint64_t>(manager._static_bvhs.size());
+        for (size_t i = 0; i < manager._static_bvhs.size(); ++i)
+        {
+            const auto & model{manager._static_bvhs[i]};
+            writer.write<uint8_t>(bool(model));
+            if (!model) continue;
+            writer.write(Pose(manager._static_transforms[i]));
+            writeMesh(writer, *model);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(manager._movable_mutex);
+        writer.write<uint64_t>(manager._movable_bvhs.size());
+        for (size_t i = 0; i < manager._movable_bvhs.size(); ++i)
+        {
+            const auto & model{manager._movable_bvhs[i]};
+            writer.write<uint8_t>(bool(model));
+            if (!model) continue;
+            writeMesh(writer, *model);
+
+            auto & wtree{*manager._wtrees[i]};
+            std::lock_guard<std::mutex> guard_wt(wtree._edit_mtx);
+            writer.write<uint64_t>(wtree._position);
+            writer.write(wtree.nodes());
+
+            std::vector<char> edge_valid{wtree._edge_valid};
+            edge_valid.resize(wtree.size(), 1);
+            writer.write(edge_valid);
+        }
+    }
+
+    std::ofstream out(filename, std::ios::out | std::ios::binary);
+    out.write(writer.buffer().data(), writer.size());
+    return bool(out);
+}
+
+bool imp::io::Snapshot::load(ObjectManager & manager, const std::string & filename)
+{
+    MappedFile file(filename);
+    if (!file.good()) return false;
+
+    BinaryReader reader(file.data(), file.size());
+    const char * magic{reader.view(sizeof(MAGIC))};
+    uint32_t version{0};
+    if (!magic || std::memcmp(magic, MAGIC, sizeof(MAGIC)) || !reader.read(version) ||
+        version != VERSION)
+        return false;
+
+    // parse everything first, the manager is only touched by a complete snapshot
+    uint64_t count{0};
+    std::vector<SlotView> statics, movables;
+
+    if (!reader.read(count) || count > reader.remaining()) return false;
+    statics.resize(count);
+    for (auto & slot : statics)
+    {
+        uint8_t used{0};
+        if (!reader.read(used)) return false;
+        slot.Used = used;
+        if (slot.Used && !(reader.read(slot.Transform) && readMesh(reader, slot.Mesh)))
+            return false;
+    }
+
+    if (!reader.read(count) || count > reader.remaining()) return false;
+    movables.resize(count);
+    for (auto & slot : movables)
+    {
+        uint8_t used{0};
+        if (!reader.read(used)) return false;
+        slot.Used = used;
+        if (!slot.Used) continue;
+        if (!readMesh(reader, slot.Mesh) || !reader.read(slot.Position) ||
+            !reader.read(slot.Nodes) || !reader.read(slot.EdgeValid) ||
+            slot.EdgeValid.size() != slot.Nodes.size())
+            return false;
+        if (slot.Nodes.size() && slot.Position >= slot.Nodes.size()) return false;
+        for (size_t n = 0; n < slot.Nodes.size(); ++n)
+            if (!slot.Nodes[n].isRoot() && slot.Nodes[n].Parent >= n) return false;
+    }
+
+    std::vector<std::shared_ptr<fcl::BVHModel<fcl::OBBf>>> static_models, movable_models;
+    if (!buildMeshes(manager._meshes, statics, static_models) ||
+        !buildMeshes(manager._meshes, movables, movable_models))
+        return false;
+
+    {
+        std::lock_guard<std::mutex> guard(manager._static_mutex);
+        manager._static_pending.clear(); // running builds are discarded
+        manager._static_bvhs = static_models;
+        manager._static_transforms.assign(statics.size(), Configuration());
+        manager._static_collision_objects.assign(statics.size(), nullptr);
+        for (size_t i = 0; i < statics.size(); ++i)
+        {
+            if (!statics[i].Used) continue;
+            manager._static_transforms[i] = statics[i].Transform;
+            manager._static_collision_objects[i] = std::make_shared<fcl::CollisionObjectf>(
+                static_models[i], manager.toFCL(statics[i].Transform));
+        }
+        manager.publishStatics();
+        manager._scene_version++;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(manager._movable_mutex);
+        manager._movable_pending.clear();
+        manager._movable_bvhs = movable_models;
+        manager._ests.clear();
+        manager._wtrees.clear();
+        for (size_t i = 0; i < movables.size(); ++i)
+        {
+            if (!movables[i].Used)
+            {
+                manager._ests.emplace_back(nullptr);
+                manager._wtrees.emplace_back(nullptr);
+                continue;
+            }
+
+            manager._ests.emplace_back(std::make_shared<imp::EST>(manager, i));
+            auto wtree = std::make_shared<imp::WorldTree>(i);
+            wtree->_nodes.assign(std::move(movables[i].Nodes));
+            wtree->_position = movables[i].Position;
+            wtree->_edge_valid = std::move(movables[i].EdgeValid);
+            wtree->_kdtree->insertBulk();
+            manager._wtrees.emplace_back(wtree);
+        }
+        manager.publishMovables();
+    }
+
+    return true;
+}
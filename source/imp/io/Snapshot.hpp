@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "imp/ObjectManager.hpp"
+
+namespace imp::io
+{
+
+/**
+ * @brief Binary snapshot of the scene and the exploration knowledge of an ObjectManager.
+ *
+ * File layout (native byte order): "IMPS", uint32 version, uint64 static slot count and per
+ * slot: uint8 used, Pose transform, mesh; uint64 movable slot count and per slot: uint8 used,
+ * mesh, uint64 world tree position, WorldNode array, uint8 edge validity array. A mesh is a Vector3f array followed by a
+ * uint32 triangle index array, arrays are prefixed by their uint64 element count. Unused slots
+ * are kept, so object ids stay valid across a reload.
+ *
+ * Loading maps the file and copies the node arrays in bulk. fcl keeps the BVH nodes private,
+ * so the models are rebuilt (in parallel) from the mapped vertices, the world tree kd-trees
+ * are indexed in bulk using the stored ratings.
+ */
+class Snapshot
+{
+    /////////
+    // data
+    /////////
+private:
+    static constexpr char MAGIC[4]{'I', 'M', 'P', 'S'};
+    static constexpr uint32_t VERSION{2};
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Writes the snapshot of manager to filename.
+     *
+     * @return Whether the file could be written.
+     */
+    static bool save(ObjectManager & manager, const std::string & filename);
+
+    /**
+     * @brief Replaces all objects, explorations and world trees of manager with the snapshot
+     * stored in filename. The manager is left untouched if the file is missing or invalid.
+     *
+     * @return Whether the snapshot was loaded.
+     */
+    static bool load(ObjectManager & manager, const std::string & filename);
+};
+
+} // namespace imp::io
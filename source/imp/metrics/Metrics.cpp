@@ -0,0 +1,162 @@
+#include "imp/metrics/Metrics.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+
+struct CounterInfo
+{
+    const char * Name;
+    const char * Help;
+};
+
+struct HistogramInfo
+{
+    const char * Name;
+    const char * Labels; // without braces
+    const char * Help;
+};
+
+constexpr CounterInfo COUNTERS[size_t(imp::metrics::Counter::COUNT)]{
+    {"imp_collision_queries_total", "Collision queries of a movable against the scene."},
+    {"imp_narrow_phase_calls_total", "Narrow phase checks against single static objects."},
+    {"imp_edges_accepted_total", "Validated motions found collision free."},
+    {"imp_edges_rejected_total", "Validated motions found colliding."},
+    {"imp_explorations_total", "Started EST explorations."},
+    {"imp_est_iterations_total", "EST exploration steps."},
+    {"imp_est_nodes_total", "Nodes accepted into EST trees."},
+    {"imp_mesh_cache_hits_total", "Meshes served by an already built model."},
+    {"imp_mesh_cache_misses_total", "Meshes whose model had to be built."},
+    {"imp_roadmap_hits_total", "Path-to requests answered by the world tree."},
+    {"imp_roadmap_misses_total", "Path-to roadmap queries that found no path."},
+    {"imp_roadmap_edges_invalidated_total", "World tree edges blocked by added objects."},
+    {"imp_roadmap_edges_restored_total", "World tree edges freed by removed objects."},
+    {"imp_stale_joins_total", "Joined explorations revalidated against a changed scene."},
+    {"imp_rejected_joins_total", "Explorations not rooted at the world tree position."},
+};
+
+constexpr HistogramInfo HISTOGRAMS[size_t(imp::metrics::Histogram::COUNT)]{
+    {"imp_explore_seconds", "", "Duration of EST explorations."},
+    {"imp_est_phase_seconds", "phase=\"sample\"", "Duration of the phases of an EST step."},
+    {"imp_est_phase_seconds", "phase=\"validate\"", ""},
+    {"imp_est_phase_seconds", "phase=\"insert\"", ""},
+    {"imp_est_phase_seconds", "phase=\"match\"", ""},
+};
+
+constexpr const char * REQUEST_HISTOGRAM{"imp_request_duration_seconds"};
+
+void fold(imp::metrics::HistogramData & target, const imp::metrics::HistogramData & source)
+{
+    for (size_t b = 0; b < target.Buckets.size(); ++b)
+        target.Buckets[b].fetch_add(source.Buckets[b].load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+    target.SumNanoseconds.fetch_add(source.SumNanoseconds.load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+}
+
+void fold(imp::metrics::ThreadBlock & target, const imp::metrics::ThreadBlock & source)
+{
+    for (size_t c = 0; c < target.Counters.size(); ++c)
+        target.Counters[c].fetch_add(source.Counters[c].load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+    for (size_t h = 0; h < target.Histograms.size(); ++h)
+        fold(target.Histograms[h], source.Histograms[h]);
+}
+
+void header(std::ostream & os, const char * name, const char * help, const char * type)
+{
+    os << "# HELP " << name << " " << help << "\n";
+    os << "# TYPE " << name << " " << type << "\n";
+}
+
+void histogram(std::ostream & os, const char * name, const std::string & labels,
+               const imp::metrics::HistogramData & data)
+{
+    const std::string PREFIX{labels.empty() ? "" : labels + ","};
+    const std::string SUFFIX{labels.empty() ? "" : "{" + labels + "}"};
+
+    uint64_t cumulative{0};
+    for (size_t b = 0; b < data.Buckets.size(); ++b)
+    {
+        cumulative += data.Buckets[b].load(std::memory_order_relaxed);
+        os << name << "_bucket{" << PREFIX << "le=\"";
+        if (b < imp::metrics::BUCKETS.size())
+            os << imp::metrics::BUCKETS[b];
+        else
+            os << "+Inf";
+        os << "\"} " << cumulative << "\n";
+    }
+    os << name << "_sum" << SUFFIX << " "
+       << data.SumNanoseconds.load(std::memory_order_relaxed) * 1e-9 << "\n";
+    os << name << "_count" << SUFFIX << " " << cumulative << "\n";
+}
+
+} // namespace
+
+imp::metrics::Registry & imp::metrics::Registry::get()
+{
+    static Registry instance;
+    return instance;
+}
+
+imp::metrics::ThreadBlock * imp::metrics::Registry::attach()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _blocks.emplace_back(std::make_unique<ThreadBlock>()).get();
+}
+
+void imp::metrics::Registry::detach(ThreadBlock * block)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    fold(_retired, *block);
+    _blocks.remove_if([block](const auto & b) { return b.get() == block; });
+}
+
+void imp::metrics::Registry::request(const std::string & endpoint,
+                                     const time::duration_t & duration)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _implementation::observe(_requests[endpoint], duration);
+}
+
+void imp::metrics::Registry::render(std::ostream & os, const std::vector<Gauge> & gauges)
+{
+    ThreadBlock total;
+    std::stringstream requests;
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        fold(total, _retired);
+        for (const auto & block : _blocks) fold(total, *block);
+
+        if (!_requests.empty())
+            header(requests, REQUEST_HISTOGRAM, "Handler duration per endpoint.", "histogram");
+        for (const auto & [endpoint, data] : _requests)
+            histogram(requests, REQUEST_HISTOGRAM, "endpoint=\"" + endpoint + "\"", data);
+    }
+
+    os << std::setprecision(9);
+    for (size_t c = 0; c < size_t(Counter::COUNT); ++c)
+    {
+        header(os, COUNTERS[c].Name, COUNTERS[c].Help, "counter");
+        os << COUNTERS[c].Name << " " << total.Counters[c].load(std::memory_order_relaxed)
+           << "\n";
+    }
+
+    for (size_t h = 0; h < size_t(Histogram::COUNT); ++h)
+    {
+        // labelled series of one metric share the header
+        if (!h || std::string(HISTOGRAMS[h].Name) != HISTOGRAMS[h - 1].Name)
+            header(os, HISTOGRAMS[h].Name, HISTOGRAMS[h].Help, "histogram");
+        histogram(os, HISTOGRAMS[h].Name, HISTOGRAMS[h].Labels, total.Histograms[h]);
+    }
+
+    os << requests.str();
+
+    for (const auto & gauge : gauges)
+    {
+        header(os, gauge.Name, gauge.Help, "gauge");
+        os << gauge.Name << " " << gauge.Value << "\n";
+    }
+}
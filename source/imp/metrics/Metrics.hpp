@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "imp/time/Timer.hpp"
+
+namespace imp::metrics
+{
+
+enum class Counter : size_t
+{
+    CollisionQueries, // ObjectManager::collides
+    NarrowPhaseCalls, // fcl::collide against a single static object
+    EdgesAccepted,    // collision free isCollisionFreePath
+    EdgesRejected,    // colliding isCollisionFreePath
+    Explorations,
+    ESTIterations,
+    ESTNodes, // accepted nodes
+    MeshCacheHits,
+    MeshCacheMisses,
+    RoadmapHits, // path-to answered by the world tree
+    RoadmapMisses, // roadmap query without a path (not issued without free matchees)
+    RoadmapEdgesInvalidated, // by an added static object
+    RoadmapEdgesRestored,    // by a removed static object
+    StaleJoins,              // joined explorations revalidated against a changed scene
+    RejectedJoins,           // explorations not rooted at the tree position, dropped by join
+    COUNT
+};
+
+enum class Histogram : size_t
+{
+    Explore,
+    ESTSample,
+    ESTValidate,
+    ESTInsert,
+    ESTMatch,
+    COUNT
+};
+
+/**
+ * @brief A gauge sampled on scrape.
+ */
+struct Gauge
+{
+    const char * Name;
+    const char * Help;
+    double Value;
+};
+
+// upper bounds of the histogram buckets (seconds), a final +Inf bucket is implicit
+inline constexpr std::array<double, 16> BUCKETS{0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+                                                0.01,   0.025,   0.05,   0.1,   0.25,   0.5,
+                                                1.0,    2.5,     5.0,    10.0};
+
+struct HistogramData
+{
+    std::array<std::atomic<uint64_t>, BUCKETS.size() + 1> Buckets{}; // not cumulative
+    std::atomic<uint64_t> SumNanoseconds{0};
+};
+
+/**
+ * @brief Counters and histograms of a single thread. Only the owning thread writes, the
+ * scrape reads concurrently (relaxed).
+ */
+struct ThreadBlock
+{
+    std::array<std::atomic<uint64_t>, size_t(Counter::COUNT)> Counters{};
+    std::array<HistogramData, size_t(Histogram::COUNT)> Histograms{};
+};
+
+/**
+ * @brief Process wide metric registry (Registry::get()). The hot paths write thread local
+ * blocks without synchronization, a scrape sums up the blocks of all threads. Blocks of
+ * finished threads are folded into a retired block.
+ */
+class Registry
+{
+    /////////
+    // data
+    /////////
+private:
+    std::mutex _mutex;
+    std::list<std::unique_ptr<ThreadBlock>> _blocks;
+    ThreadBlock _retired;
+    std::map<std::string, HistogramData> _requests; // latency per endpoint
+
+    /////////
+    // methods
+    /////////
+public:
+    static Registry & get();
+
+    ThreadBlock * attach();
+
+    void detach(ThreadBlock * block);
+
+    /**
+     * @brief Records the latency of a request (not a hot path, locks).
+     */
+    void request(const std::string & endpoint, const time::duration_t & duration);
+
+    /**
+     * @brief Writes all metrics in the Prometheus text exposition format (version 0.0.4).
+     */
+    void render(std::ostream & os, const std::vector<Gauge> & gauges);
+};
+
+namespace _implementation
+{
+
+struct Attachment
+{
+    ThreadBlock * Block;
+
+    Attachment() : Block{Registry::get().attach()} {}
+    ~Attachment() { Registry::get().detach(Block); }
+};
+
+inline ThreadBlock & local()
+{
+    thread_local Attachment attachment;
+    return *attachment.Block;
+}
+
+// single writer, a plain load and store is enough (no locked instruction)
+inline void bump(std::atomic<uint64_t> & value, const uint64_t N)
+{
+    value.store(value.load(std::memory_order_relaxed) + N, std::memory_order_relaxed);
+}
+
+inline void observe(HistogramData & histogram, const time::duration_t & duration)
+{
+    const double SECONDS{std::chrono::duration<double>(duration).count()};
+    size_t bucket{0};
+    while (bucket < BUCKETS.size() && SECONDS > BUCKETS[bucket]) bucket++;
+    bump(histogram.Buckets[bucket], 1);
+    bump(histogram.SumNanoseconds,
+         std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+} // namespace _implementation
+
+inline void add(const Counter COUNTER, const uint64_t N = 1)
+{
+    _implementation::bump(_implementation::local().Counters[size_t(COUNTER)], N);
+}
+
+inline void observe(const Histogram HISTOGRAM, const time::duration_t & duration)
+{
+    _implementation::observe(_implementation::local().Histograms[size_t(HISTOGRAM)], duration);
+}
+
+/**
+ * @brief Observes its lifetime in the given histogram.
+ */
+class ScopedTimer
+{
+    /////////
+    // data
+    /////////
+private:
+    const Histogram _HISTOGRAM;
+    time::Timer _timer;
+
+    /////////
+    // constructors
+    /////////
+public:
+    explicit ScopedTimer(const Histogram HISTOGRAM) : _HISTOGRAM{HISTOGRAM} {}
+    ~ScopedTimer() { observe(_HISTOGRAM, _timer.elapsed()); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer & operator=(const ScopedTimer &) = delete;
+};
+
+} // namespace imp::metrics
@@ -1,5 +1,7 @@
 #include "imp/random/Sampler.hpp"
 
+#include <thread>
+
 namespace imp
 {
 
@@ -14,7 +16,8 @@ imp::random::_implementation::Sampler & imp::random::_implementation::Sampler::g
     if (__imp_sampler) return *__imp_sampler.get();
     std::lock_guard<std::mutex> guard(__imp_sampler_lock);
     __imp_sampler = std::make_unique<imp::random::_implementation::Sampler>(
-        static_cast<int>(std::chrono::system_clock::now().time_since_epoch().count()));
+        static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()),
+        static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
     return *__imp_sampler.get();
 }
 
@@ -124,14 +127,14 @@ imp::Configuration imp::random::_implementation::Sampler::randTargetConfiguratio
         fcl::Vector3f{0.0f, 0.0f, 1.0f},          //
         connection                                //
     );
-    auto cone = Sampler().randUniformInCone(  //
+    auto cone = randUniformInCone(            //
         50.0f,                                //
         -REPAIR_MAX_POSITIONAL_DISTANCE,      //
         2.0f * REPAIR_MAX_POSITIONAL_DISTANCE //
     );
 
     fcl::Vector3f positional_change = cone_rotation.toRotationMatrix() * cone;
-    auto rotational_change = Sampler().randLimitUnitRotation(REPAIR_MAX_ROTATIONAL_DISTANCE);
+    auto rotational_change = randLimitUnitRotation(REPAIR_MAX_ROTATIONAL_DISTANCE);
 
     imp::Configuration config;
     config.Position = positional_change;
@@ -2,6 +2,8 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <fcl/fcl.h>
 #include <numbers>
 #include <random>
@@ -13,6 +15,49 @@
 namespace imp::random
 {
 
+/**
+ * @brief Counter-based random bit generator. The n-th output is a pure function of the key,
+ * the stream and n (splitmix64 finalizer), so independent streams can be created for free and
+ * yield the same numbers regardless of which thread consumes them.
+ */
+class CounterEngine
+{
+    /////////
+    // data
+    /////////
+private:
+    uint64_t _key{0};
+    uint64_t _counter{0};
+
+    /////////
+    // constructors
+    /////////
+public:
+    using result_type = uint32_t;
+
+    CounterEngine() = default;
+    CounterEngine(uint64_t key, uint64_t stream = 0) : _key{mix(mix(key) ^ stream)} {}
+
+    /////////
+    // methods
+    /////////
+public:
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    inline result_type operator()()
+    {
+        return static_cast<result_type>(mix(_key + 0x9E3779B97F4A7C15ull * ++_counter) >> 32);
+    }
+
+    static constexpr uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
 namespace _implementation
 {
 
@@ -20,7 +65,8 @@ namespace _implementation
  * @brief Class that capsules various sampling methods for motion planning, such as
  * limited random rotations. It is intended to be used in a multithreaded environment.
  * Use imp::random::Sampler() to get the thread local instance of the sampler. The seed is
- * ensured to be different for each instance.
+ * ensured to be different for each instance. Use imp::random::Sampler(seed, stream) for
+ * reproducible sequences.
  *
  * @author Ronja Schnur (rschnur@students.uni-mainz.de)
  */
@@ -30,7 +76,7 @@ class Sampler
     // data
     /////////
 private:
-    std::mt19937 _random_engine;
+    CounterEngine _random_engine;
     std::uniform_real_distribution<float> _distribution;
     std::uniform_int_distribution<unsigned int> _seed_distribution;
     std::uniform_int_distribution<size_t> _coin_distribution;
@@ -41,7 +87,11 @@ private:
 public:
     Sampler() : _coin_distribution(0, 1){};
 
-    Sampler(unsigned int seed) : _random_engine{std::mt19937(seed)}, _coin_distribution(0, 1) {}
+    Sampler(unsigned int seed) : _random_engine{seed}, _coin_distribution(0, 1) {}
+
+    Sampler(uint64_t seed, uint64_t stream)
+        : _random_engine{seed, stream}, _coin_distribution(0, 1)
+    {}
 
     /////////
     // methods
@@ -90,4 +140,15 @@ public:
  */
 inline _implementation::Sampler & Sampler() { return _implementation::Sampler::get(); }
 
+/**
+ * @brief Get an independent sampler for the given stream of the given seed. Equal arguments
+ * always yield the same sequence, which makes parallel sampling reproducible.
+ *
+ * @return _implementation::Sampler The sampler instance.
+ */
+inline _implementation::Sampler Sampler(uint64_t seed, uint64_t stream)
+{
+    return _implementation::Sampler(seed, stream);
+}
+
 } // namespace imp::random
\ No newline at end of file
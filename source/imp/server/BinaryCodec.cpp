@@ -0,0 +1,98 @@
+#include "imp/server/BinaryCodec.hpp"
+
+#include <cstring>
+
+static_assert(sizeof(fcl::Vector3f) == 3 * sizeof(float));
+
+void imp::server::BinaryCodec::writeHeader(io::BinaryWriter & writer)
+{
+    writer.append(MAGIC, sizeof(MAGIC));
+    writer.write(VERSION);
+}
+
+bool imp::server::BinaryCodec::readHeader(io::BinaryReader & reader)
+{
+    const char * magic{reader.view(sizeof(MAGIC))};
+    uint32_t version{0};
+    return magic && !std::memcmp(magic, MAGIC, sizeof(MAGIC)) && reader.read(version) &&
+           version == VERSION;
+}
+
+void imp::server::BinaryCodec::write(io::BinaryWriter & writer, const Configuration & pose)
+{
+    writer.write(Pose(pose));
+}
+
+void imp::server::BinaryCodec::write(io::BinaryWriter & writer,
+                                     const std::vector<Configuration> & poses)
+{
+    writer.write<uint64_t>(poses.size());
+    for (const auto & pose : poses) writer.write(Pose(pose));
+}
+
+void imp::server::BinaryCodec::write(io::BinaryWriter & writer,
+                                     const std::vector<fcl::Vector3f> & vertices,
+                                     const std::vector<fcl::Triangle> & triangles)
+{
+    writer.write<uint64_t>(vertices.size());
+    writer.append(vertices.data(), vertices.size() * sizeof(fcl::Vector3f));
+
+    std::vector<uint32_t> indices(3 * triangles.size());
+    for (size_t t = 0; t < triangles.size(); ++t)
+    {
+        for (size_t k = 0; k < 3; ++k)
+            indices[3 * t + k] = static_cast<uint32_t>(triangles[t][k]);
+    }
+    writer.write(indices);
+}
+
+bool imp::server::BinaryCodec::read(io::BinaryReader & reader, Configuration & pose)
+{
+    Pose value;
+    if (!reader.read(value)) return false;
+    pose = Configuration(value);
+    return true;
+}
+
+bool imp::server::BinaryCodec::read(io::BinaryReader & reader, std::vector<Configuration> & poses)
+{
+    auto [data, count] = reader.viewArray<Pose>();
+    if (!data) return false;
+
+    poses.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Pose value;
+        std::memcpy(&value, data + i * sizeof(Pose), sizeof(Pose));
+        poses[i] = Configuration(value);
+    }
+    return true;
+}
+
+bool imp::server::BinaryCodec::read(io::BinaryReader & reader,
+                                    std::vector<fcl::Vector3f> & vertices,
+                                    std::vector<fcl::Triangle> & triangles)
+{
+    uint64_t count{0};
+    if (!reader.read(count) || count > reader.remaining() / sizeof(fcl::Vector3f)) return false;
+    vertices.resize(static_cast<size_t>(count));
+    const char * data{reader.view(vertices.size() * sizeof(fcl::Vector3f))};
+    if (!vertices.empty())
+        std::memcpy(vertices.data(), data, vertices.size() * sizeof(fcl::Vector3f));
+
+    auto [indices, num_indices] = reader.viewArray<uint32_t>();
+    if (!reader.good() || num_indices % 3 != 0) return false;
+
+    triangles.resize(num_indices / 3);
+    for (size_t t = 0; t < triangles.size(); ++t)
+    {
+        uint32_t index[3];
+        std::memcpy(index, indices + 3 * t * sizeof(uint32_t), sizeof(index));
+        for (size_t k = 0; k < 3; ++k)
+        {
+            if (index[k] >= vertices.size()) return false;
+            triangles[t][k] = static_cast<size_t>(index[k]);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "fcl/fcl.h"
+#include "imp/Configuration.hpp"
+#include "imp/io/Binary.hpp"
+
+namespace imp::server
+{
+
+/**
+ * @brief Wire format of the binary (application/octet-stream) endpoints. A body starts with
+ * "IMPB" and a uint32 version, followed by the values of the endpoint in native (little-endian)
+ * byte order. Poses are packed as imp::Pose (position x, y, z, rotation w, x, y, z), arrays
+ * are prefixed by their uint64 element count (see io::BinaryWriter). A mesh is a Vector3f
+ * array followed by a uint32 triangle index array.
+ *
+ * Bodies:
+ *  /create-bin         uint8 movable, Pose transform, mesh
+ *  /collides-any-bin   int32 movable id, Pose array
+ *  /path-to-bin        int32 movable id, Pose start, Pose array (u path)
+ *  /path-to-get-bin    (response) int64 matchee index, Pose array (path)
+ */
+class BinaryCodec
+{
+    /////////
+    // data
+    /////////
+public:
+    static constexpr const char * CONTENT_TYPE{"application/octet-stream"};
+
+private:
+    static constexpr char MAGIC[4]{'I', 'M', 'P', 'B'};
+    static constexpr uint32_t VERSION{1};
+
+    /////////
+    // methods
+    /////////
+public:
+    static void writeHeader(io::BinaryWriter & writer);
+    static bool readHeader(io::BinaryReader & reader);
+
+    static void write(io::BinaryWriter & writer, const Configuration & pose);
+    static void write(io::BinaryWriter & writer, const std::vector<Configuration> & poses);
+    static void write(io::BinaryWriter & writer, const std::vector<fcl::Vector3f> & vertices,
+                      const std::vector<fcl::Triangle> & triangles);
+
+    static bool read(io::BinaryReader & reader, Configuration & pose);
+    static bool read(io::BinaryReader & reader, std::vector<Configuration> & poses);
+
+    /**
+     * @brief Reads a mesh, fails on triangle indices out of range.
+     */
+    static bool read(io::BinaryReader & reader, std::vector<fcl::Vector3f> & vertices,
+                     std::vector<fcl::Triangle> & triangles);
+};
+
+} // namespace imp::server
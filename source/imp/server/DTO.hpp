@@ -24,6 +24,7 @@ class ObjectCreationResult : public oatpp::DTO
     DTO_INIT(ObjectCreationResult, DTO)
     DTO_FIELD(Boolean, movable);
     DTO_FIELD(Int32, id);
+    DTO_FIELD(Boolean, ready); // false while the model is built in the background
 };
 
 class ObjectsTrashRequest : public oatpp::DTO
@@ -69,6 +70,34 @@ class ObjectCreationRequest : public oatpp::DTO
     DTO_FIELD(Float32, rotation_x);
     DTO_FIELD(Float32, rotation_y);
     DTO_FIELD(Float32, rotation_z);
+    DTO_FIELD(Boolean, build_async) = false; // answer at once, poll /create-status
+};
+
+class ObjectsCreationRequest : public oatpp::DTO
+{
+    DTO_INIT(ObjectsCreationRequest, DTO)
+    DTO_FIELD(List<Object<ObjectCreationRequest>>, objects); // always built in the background
+};
+
+class ObjectsCreationResult : public oatpp::DTO
+{
+    DTO_INIT(ObjectsCreationResult, DTO)
+    DTO_FIELD(List<Object<ObjectCreationResult>>, objects); // in the order of the request
+};
+
+class ObjectStatusRequest : public oatpp::DTO
+{
+    DTO_INIT(ObjectStatusRequest, DTO)
+    DTO_FIELD(Boolean, movable);
+    DTO_FIELD(Int32, id);
+};
+
+class ObjectStatusResult : public oatpp::DTO
+{
+    DTO_INIT(ObjectStatusResult, DTO)
+    DTO_FIELD(Boolean, movable);
+    DTO_FIELD(Int32, id);
+    DTO_FIELD(String, state); // "missing", "pending" or "ready"
 };
 
 class CollisionRequest : public oatpp::DTO
@@ -156,6 +185,10 @@ class PathToRequest : public oatpp::DTO
     DTO_FIELD(List<Float32>, u_rotations_x);
     DTO_FIELD(List<Float32>, u_rotations_y);
     DTO_FIELD(List<Float32>, u_rotations_z);
+
+    // scheduling: higher priorities run first, the queue is bounded per client
+    DTO_FIELD(Int32, priority) = 0;
+    DTO_FIELD(String, client) = "";
 };
 
 class PathToResult : public oatpp::DTO
@@ -185,12 +218,32 @@ class PathToGetRequest : public oatpp::DTO
     DTO_FIELD(Int32, movable_id);
 };
 
+class PathToWaitRequest : public oatpp::DTO
+{
+    DTO_INIT(PathToWaitRequest, DTO)
+    DTO_FIELD(Int32, path_to_request_id);
+    DTO_FIELD(Int32, movable_id);
+    DTO_FIELD(Int32, timeout_ms) = 10000; // clamped to PATH_TO_WAIT_MAX_TIMEOUT
+};
+
 class DumpRequest : public oatpp::DTO
 {
     DTO_INIT(DumpRequest, DTO)
     DTO_FIELD(Int32, movable_id);
 };
 
+class SnapshotRequest : public oatpp::DTO
+{
+    DTO_INIT(SnapshotRequest, DTO)
+    DTO_FIELD(String, filename) = "snapshot.imps";
+};
+
+class TraceRequest : public oatpp::DTO
+{
+    DTO_INIT(TraceRequest, DTO)
+    DTO_FIELD(Int32, path_to_request_id); // all buffered spans if not given
+};
+
 class PathToGetResult : public oatpp::DTO
 {
     DTO_INIT(PathToGetResult, DTO)
@@ -207,12 +260,102 @@ class PathToGetResult : public oatpp::DTO
     DTO_FIELD(List<Float32>, p_rotations_z);
 };
 
+class PathRepairRequest : public oatpp::DTO
+{
+    DTO_INIT(PathRepairRequest, DTO)
+
+    DTO_FIELD(Int32, movable_id);
+
+    // previously returned path including its start pose
+    DTO_FIELD(List<Float32>, p_positions_x);
+    DTO_FIELD(List<Float32>, p_positions_y);
+    DTO_FIELD(List<Float32>, p_positions_z);
+    DTO_FIELD(List<Float32>, p_rotations_w);
+    DTO_FIELD(List<Float32>, p_rotations_x);
+    DTO_FIELD(List<Float32>, p_rotations_y);
+    DTO_FIELD(List<Float32>, p_rotations_z);
+};
+
+class PathRepairResult : public oatpp::DTO
+{
+    DTO_INIT(PathRepairResult, DTO)
+
+    DTO_FIELD(Boolean, successful);
+    DTO_FIELD(Int32, repaired_gaps);
+
+    // p path (the unchanged input if the repair failed)
+    DTO_FIELD(List<Float32>, p_positions_x);
+    DTO_FIELD(List<Float32>, p_positions_y);
+    DTO_FIELD(List<Float32>, p_positions_z);
+    DTO_FIELD(List<Float32>, p_rotations_w);
+    DTO_FIELD(List<Float32>, p_rotations_x);
+    DTO_FIELD(List<Float32>, p_rotations_y);
+    DTO_FIELD(List<Float32>, p_rotations_z);
+};
+
 class CollisionResult : public oatpp::DTO
 {
     DTO_INIT(CollisionResult, DTO)
     DTO_FIELD(Boolean, is_colliding);
 };
 
+class BatchOperation : public oatpp::DTO
+{
+    DTO_INIT(BatchOperation, DTO)
+
+    // "collides" (start pose), "is-collision-free-path" or "new-local-closest"
+    DTO_FIELD(String, type);
+    DTO_FIELD(Int32, movable_id);
+
+    DTO_FIELD(Float32, start_position_x);
+    DTO_FIELD(Float32, start_position_y);
+    DTO_FIELD(Float32, start_position_z);
+    DTO_FIELD(Float32, start_rotation_w);
+    DTO_FIELD(Float32, start_rotation_x);
+    DTO_FIELD(Float32, start_rotation_y);
+    DTO_FIELD(Float32, start_rotation_z);
+
+    DTO_FIELD(Float32, end_position_x);
+    DTO_FIELD(Float32, end_position_y);
+    DTO_FIELD(Float32, end_position_z);
+    DTO_FIELD(Float32, end_rotation_w);
+    DTO_FIELD(Float32, end_rotation_x);
+    DTO_FIELD(Float32, end_rotation_y);
+    DTO_FIELD(Float32, end_rotation_z);
+};
+
+class BatchRequest : public oatpp::DTO
+{
+    DTO_INIT(BatchRequest, DTO)
+    DTO_FIELD(List<Object<BatchOperation>>, operations);
+};
+
+class BatchOperationResult : public oatpp::DTO
+{
+    DTO_INIT(BatchOperationResult, DTO)
+
+    DTO_FIELD(Boolean, valid); // false for unknown types and invalid ids
+
+    // collides, is-collision-free-path
+    DTO_FIELD(Boolean, is_colliding);
+
+    // new-local-closest
+    DTO_FIELD(Boolean, successful);
+    DTO_FIELD(Float32, position_x);
+    DTO_FIELD(Float32, position_y);
+    DTO_FIELD(Float32, position_z);
+    DTO_FIELD(Float32, rotation_w);
+    DTO_FIELD(Float32, rotation_x);
+    DTO_FIELD(Float32, rotation_y);
+    DTO_FIELD(Float32, rotation_z);
+};
+
+class BatchResult : public oatpp::DTO
+{
+    DTO_INIT(BatchResult, DTO)
+    DTO_FIELD(List<Object<BatchOperationResult>>, results); // in the order of the operations
+};
+
 #include OATPP_CODEGEN_END(DTO)
 
 } // namespace imp::server
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "imp/server/PathToScheduler.hpp"
+
+#include "imp/time/Tracer.hpp"
+
+imp::server::PathToScheduler::PathToScheduler()
+{
+    for (size_t i = 0; i < PATH_TO_MAX_RUNNING; ++i)
+        _workers.emplace_back(&PathToScheduler::run, this);
+}
+
+imp::server::PathToScheduler::~PathToScheduler()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _running = false;
+    }
+    _work_condition.notify_all();
+    for (auto & worker : _workers) worker.join();
+}
+
+int32_t imp::server::PathToScheduler::reserve()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _next_id++;
+}
+
+bool imp::server::PathToScheduler::submit(const int32_t ID, const size_t MOVABLE_ID,
+                                          const int32_t PRIORITY, const std::string & client,
+                                          Job job, std::shared_ptr<void> record)
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        expire();
+
+        auto & client_queued{_queued_per_client[client]};
+        if (_queued >= PATH_TO_MAX_QUEUED || client_queued >= PATH_TO_MAX_QUEUED_PER_CLIENT)
+        {
+            if (!client_queued) _queued_per_client.erase(client);
+            return false;
+        }
+
+        Task task;
+        task.MovableID = MOVABLE_ID;
+        task.Client = client;
+        task.Work = std::move(job);
+        task.Record = std::move(record);
+        _tasks.emplace(ID, std::move(task));
+        _queue.push(Ticket{PRIORITY, _sequence++, ID});
+
+        _queued++;
+        client_queued++;
+    }
+    _work_condition.notify_one();
+    return true;
+}
+
+void imp::server::PathToScheduler::publish(const int32_t ID, const size_t MOVABLE_ID,
+                                           Result result, std::optional<size_t> roadmap_node,
+                                           std::shared_ptr<void> record)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    expire();
+
+    Task task;
+    task.MovableID = MOVABLE_ID;
+    task.TaskState = State::Finished;
+    task.Value = std::move(result);
+    task.RoadmapNode = roadmap_node;
+    task.Record = std::move(record);
+    _tasks.emplace(ID, std::move(task));
+}
+
+std::optional<std::pair<size_t, bool>> imp::server::PathToScheduler::status(const int32_t ID)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    expire();
+
+    auto it = _tasks.find(ID);
+    if (it == _tasks.end() || it->second.TaskState == State::Aborting) return std::nullopt;
+    return std::make_pair(it->second.MovableID, it->second.TaskState == State::Finished);
+}
+
+std::optional<imp::server::PathToScheduler::Taken>
+imp::server::PathToScheduler::take(const int32_t ID)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _tasks.find(ID);
+    _done_condition.wait(lock, [&]() {
+        it = _tasks.find(ID);
+        return it == _tasks.end() || it->second.TaskState == State::Finished;
+    });
+    if (it == _tasks.end()) return std::nullopt;
+
+    Taken taken{it->second.MovableID, std::move(it->second.Value.value()),
+                it->second.RoadmapNode, std::move(it->second.Record)};
+    _tasks.erase(it);
+    return taken;
+}
+
+bool imp::server::PathToScheduler::abort(const int32_t ID)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    auto it = _tasks.find(ID);
+    if (it == _tasks.end()) return true;
+
+    switch (it->second.TaskState)
+    {
+    case State::Running:
+        it->second.Cancellation->cancel();
+        it->second.TaskState = State::Aborting;
+        [[fallthrough]];
+    case State::Aborting:
+        return false;
+    case State::Queued:
+        dequeue(it->second);
+        [[fallthrough]];
+    default:
+        _tasks.erase(it);
+        _done_condition.notify_all();
+        return true;
+    }
+}
+
+void imp::server::PathToScheduler::drain()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (auto & [id, task] : _tasks) task.Cancellation->cancel();
+    _tasks.clear();
+    _queue = std::priority_queue<Ticket>();
+    _queued_per_client.clear();
+    _queued = 0;
+    _done_condition.notify_all();
+
+    _done_condition.wait(lock, [this]() { return !_executing; });
+}
+
+size_t imp::server::PathToScheduler::queued()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _queued;
+}
+
+size_t imp::server::PathToScheduler::running()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _executing;
+}
+
+void imp::server::PathToScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        std::optional<Ticket> ticket;
+        _work_condition.wait_for(lock, PATH_TO_RESULT_TTL, [&]() {
+            return !_running || (ticket = next()).has_value();
+        });
+        if (!_running) break;
+
+        expire();
+        if (!ticket.has_value()) continue;
+
+        const Ticket TICKET{ticket.value()};
+        auto it = _tasks.find(TICKET.ID);
+        const size_t MOVABLE_ID{it->second.MovableID};
+
+        dequeue(it->second);
+        it->second.TaskState = State::Running;
+        Job job{std::move(it->second.Work)};
+        auto cancellation{it->second.Cancellation}; // outlives a drain
+        _executing++;
+        _busy.insert(MOVABLE_ID);
+
+        lock.unlock();
+        Result result;
+        {
+            time::TraceScope scope(TICKET.ID); // PUT /trace selects the request by its id
+            time::Span span("path-to.exploration");
+            result = job(*cancellation);
+        }
+        job = nullptr; // releases the captured state outside of the lock
+        lock.lock();
+
+        _executing--;
+        _busy.erase(MOVABLE_ID);
+        if (!_queue.empty()) _work_condition.notify_all(); // jobs of the movable may wait
+
+        it = _tasks.find(TICKET.ID);
+        if (it != _tasks.end() && it->second.TaskState == State::Aborting)
+        {
+            _tasks.erase(it);
+        }
+        else if (it != _tasks.end())
+        {
+            it->second.Value = std::move(result);
+            it->second.TaskState = State::Finished;
+            it->second.FinishedAt = time::Timer();
+        }
+        _done_condition.notify_all();
+    }
+}
+
+std::optional<imp::server::PathToScheduler::Ticket> imp::server::PathToScheduler::next()
+{
+    std::optional<Ticket> result;
+    std::vector<Ticket> skipped;
+    while (!_queue.empty() && !result.has_value())
+    {
+        const Ticket TICKET{_queue.top()};
+        _queue.pop();
+
+        auto it = _tasks.find(TICKET.ID);
+        if (it == _tasks.end() || it->second.TaskState != State::Queued) continue;
+
+        if (_busy.contains(it->second.MovableID))
+            skipped.emplace_back(TICKET);
+        else
+            result = TICKET;
+    }
+    for (const auto & ticket : skipped) _queue.push(ticket);
+    return result;
+}
+
+void imp::server::PathToScheduler::expire()
+{
+    for (auto it = _tasks.begin(); it != _tasks.end();)
+    {
+        if (it->second.TaskState == State::Finished &&
+            it->second.FinishedAt.elapsed() > PATH_TO_RESULT_TTL)
+            it = _tasks.erase(it);
+        else
+            ++it;
+    }
+}
+
+void imp::server::PathToScheduler::dequeue(const Task & task)
+{
+    _queued--;
+    if (auto it = _queued_per_client.find(task.Client); it != _queued_per_client.end())
+    {
+        if (!--it->second) _queued_per_client.erase(it);
+    }
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "imp/Cancellation.hpp"
+#include "imp/Configuration.hpp"
+#include "imp/Settings.hpp"
+#include "imp/time/Timer.hpp"
+
+namespace imp::server
+{
+
+/**
+ * @brief Registry and bounded job queue of the path-to tasks. At most PATH_TO_MAX_RUNNING
+ * explorations run at once on a fixed set of workers, waiting ones are ordered by priority
+ * (higher first) and submission. Submissions beyond PATH_TO_MAX_QUEUED (or
+ * PATH_TO_MAX_QUEUED_PER_CLIENT for a single client) are rejected, results that are not taken
+ * within PATH_TO_RESULT_TTL are dropped. Each job receives a cancellation token which is
+ * cancelled on abort. Jobs of the same movable share its EST and run one after another, a
+ * worker skips them while another one of that movable executes (a job has to finish all work
+ * on the EST, e.g. the world tree join, before it returns). All methods are thread safe.
+ */
+class PathToScheduler
+{
+    /////////
+    // nested
+    /////////
+public:
+    using Result = std::pair<int64_t, std::vector<Configuration>>;
+    using Job = std::function<Result(const CancellationToken &)>;
+
+    struct Taken
+    {
+        size_t MovableID{0};
+        Result Value;
+        std::optional<size_t> RoadmapNode; // answered by the world tree
+        std::shared_ptr<void> Record;      // see submit
+    };
+
+private:
+    enum class State
+    {
+        Queued,
+        Running,
+        Aborting, // cancelled, the job did not return yet
+        Finished
+    };
+
+    struct Task
+    {
+        size_t MovableID{0};
+        std::string Client;
+        State TaskState{State::Queued};
+        Job Work;
+        std::shared_ptr<CancellationToken> Cancellation{std::make_shared<CancellationToken>()};
+        std::optional<Result> Value;
+        std::optional<size_t> RoadmapNode;
+        std::shared_ptr<void> Record;
+        time::Timer FinishedAt;
+    };
+
+    struct Ticket
+    {
+        int32_t Priority{0};
+        uint64_t Sequence{0};
+        int32_t ID{0};
+
+        // std::priority_queue pops the largest: higher priority, then earlier submission
+        inline bool operator<(const Ticket & other) const
+        {
+            return Priority != other.Priority ? Priority < other.Priority
+                                              : Sequence > other.Sequence;
+        }
+    };
+
+    /////////
+    // data
+    /////////
+private:
+    std::mutex _mutex;
+    std::condition_variable _work_condition;
+    std::condition_variable _done_condition;
+
+    std::unordered_map<int32_t, Task> _tasks;
+    std::priority_queue<Ticket> _queue; // may hold tickets of aborted tasks, they are skipped
+    std::unordered_map<std::string, size_t> _queued_per_client;
+    size_t _queued{0};
+    size_t _executing{0}; // including aborted explorations that did not return yet
+    std::unordered_set<size_t> _busy; // movables with an executing job
+
+    int32_t _next_id{0};
+    uint64_t _sequence{0};
+    bool _running{true};
+
+    std::vector<std::thread> _workers;
+
+    /////////
+    // constructors
+    /////////
+public:
+    PathToScheduler();
+    ~PathToScheduler();
+
+    PathToScheduler(const PathToScheduler &) = delete;
+    PathToScheduler & operator=(const PathToScheduler &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Reserves the id of a task submitted or published later (e.g. to attribute the
+     * spans of the request in advance).
+     */
+    int32_t reserve();
+
+    /**
+     * @brief Queues an exploration under a reserved id. The record (e.g. a request log entry)
+     * lives as long as the task and is handed over by take, it is released once the result is
+     * delivered.
+     *
+     * @return false if the queue is saturated.
+     */
+    bool submit(const int32_t ID, const size_t MOVABLE_ID, const int32_t PRIORITY,
+                const std::string & client, Job job, std::shared_ptr<void> record = nullptr);
+
+    /**
+     * @brief Registers an already known result (e.g. a roadmap answer) under a reserved id.
+     */
+    void publish(const int32_t ID, const size_t MOVABLE_ID, Result result,
+                 std::optional<size_t> roadmap_node, std::shared_ptr<void> record = nullptr);
+
+    /**
+     * @brief The movable of a task and whether its result is available, std::nullopt if there
+     * is no such task.
+     */
+    std::optional<std::pair<size_t, bool>> status(const int32_t ID);
+
+    /**
+     * @brief Removes the task and returns its result, waits if it is still queued or running.
+     */
+    std::optional<Taken> take(const int32_t ID);
+
+    /**
+     * @brief Removes the task, a running job is cancelled and the task is removed once it
+     * returned. Never blocks.
+     *
+     * @return Whether the task is gone (the abort is acknowledged), poll again otherwise.
+     */
+    bool abort(const int32_t ID);
+
+    /**
+     * @brief Removes all tasks, cancels the running jobs and waits until every worker is idle.
+     */
+    void drain();
+
+    /**
+     * @brief Number of waiting explorations.
+     */
+    size_t queued();
+
+    /**
+     * @brief Number of explorations being executed (including aborted ones not returned yet).
+     */
+    size_t running();
+
+private:
+    void run();
+
+    /**
+     * @brief Pops the first waiting ticket whose movable is not busy (lock held), the skipped
+     * ones stay queued. Tickets of aborted tasks are dropped.
+     */
+    std::optional<Ticket> next();
+
+    /**
+     * @brief Drops unclaimed results older than PATH_TO_RESULT_TTL (lock held).
+     */
+    void expire();
+
+    /**
+     * @brief Releases the queue slot of a queued task (lock held).
+     */
+    void dequeue(const Task & task);
+};
+
+} // namespace imp::server
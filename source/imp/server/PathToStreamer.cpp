@@ -0,0 +1,185 @@
+#include "imp/server/PathToStreamer.hpp"
+
+#include <charconv>
+
+#include "imp/server/WebSocket.hpp"
+
+imp::server::PathToStreamer::PathToStreamer(FrameSource source, ResultSource result)
+    : _source{std::move(source)}, _result{std::move(result)}
+{
+    _worker = std::thread(&PathToStreamer::run, this);
+}
+
+imp::server::PathToStreamer::~PathToStreamer() { stop(); }
+
+void imp::server::PathToStreamer::handleConnection(
+    const oatpp::provider::ResourceHandle<oatpp::data::stream::IOStream> & connection,
+    const std::shared_ptr<const ParameterMap> & params)
+{
+    Subscriber subscriber{connection};
+
+    const oatpp::String * id{nullptr};
+    if (params)
+    {
+        if (auto it = params->find("path_to_request_id"); it != params->end()) id = &it->second;
+    }
+    if (!id || !*id ||
+        std::from_chars((*id)->data(), (*id)->data() + (*id)->size(), subscriber.RequestID).ec !=
+            std::errc())
+    {
+        connection.invalidator->invalidate(connection.object);
+        return;
+    }
+
+    // the upgraded connection is served by the streaming thread only, which must not block
+    connection.object->setInputStreamIOMode(oatpp::data::stream::IOMode::ASYNCHRONOUS);
+    connection.object->setOutputStreamIOMode(oatpp::data::stream::IOMode::ASYNCHRONOUS);
+
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (!_running)
+        {
+            connection.invalidator->invalidate(connection.object);
+            return;
+        }
+        _subscribers.emplace_back(std::move(subscriber));
+    }
+    _condition.notify_all();
+}
+
+void imp::server::PathToStreamer::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _running = false;
+    }
+    _condition.notify_all();
+    if (_worker.joinable() && _worker.get_id() != std::this_thread::get_id()) _worker.join();
+}
+
+void imp::server::PathToStreamer::run()
+{
+    std::vector<Subscriber> subscribers;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait_for(lock, PATH_TO_STREAM_INTERVAL, [this]() {
+                return !_running || !_subscribers.empty();
+            });
+            if (!_running) break;
+
+            // newly subscribed connections join the running ones
+            for (auto & subscriber : _subscribers) subscribers.emplace_back(std::move(subscriber));
+            _subscribers.clear();
+        }
+
+        std::vector<Subscriber> remaining;
+        for (auto & subscriber : subscribers)
+        {
+            if (serve(subscriber))
+                remaining.emplace_back(std::move(subscriber));
+            else
+                subscriber.Connection.invalidator->invalidate(subscriber.Connection.object);
+        }
+        std::swap(subscribers, remaining);
+    }
+
+    for (auto & subscriber : subscribers)
+        subscriber.Connection.invalidator->invalidate(subscriber.Connection.object);
+}
+
+bool imp::server::PathToStreamer::serve(Subscriber & subscriber)
+{
+    if (!receive(subscriber)) return false;
+
+    if (!subscriber.Closing && !subscriber.Result.has_value())
+    {
+        auto frame{_source(subscriber.RequestID)};
+        if (frame.Finished)
+        {
+            subscriber.Result = _result(subscriber.RequestID);
+        }
+        else if (frame.Last)
+        {
+            queue(subscriber, WebSocket::OPCODE_TEXT, frame.Payload);
+            queue(subscriber, WebSocket::OPCODE_CLOSE, "");
+        }
+        else if (frame.Payload != subscriber.Last && subscriber.Outgoing.empty())
+        {
+            queue(subscriber, WebSocket::OPCODE_TEXT, frame.Payload);
+            subscriber.Last = std::move(frame.Payload);
+        }
+    }
+
+    if (subscriber.Result.has_value() &&
+        subscriber.Result->wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        if (!subscriber.Closing) // the client may have closed meanwhile
+        {
+            queue(subscriber, WebSocket::OPCODE_TEXT, subscriber.Result->get());
+            queue(subscriber, WebSocket::OPCODE_CLOSE, "");
+        }
+        subscriber.Result.reset();
+    }
+
+    // a result still in production is taken (and joined) without the subscriber
+    return flush(subscriber) && !(subscriber.Closing && subscriber.Outgoing.empty());
+}
+
+bool imp::server::PathToStreamer::receive(Subscriber & subscriber)
+{
+    char buffer[512];
+    while (true)
+    {
+        const auto READ{subscriber.Connection.object->readSimple(buffer, sizeof(buffer))};
+        if (READ == oatpp::IOError::RETRY_READ || READ == oatpp::IOError::RETRY_WRITE) break;
+        if (READ <= 0) return false; // closed or broken
+        subscriber.Incoming.append(buffer, static_cast<size_t>(READ));
+        if (subscriber.Incoming.size() > PATH_TO_STREAM_MAX_INCOMING) return false;
+    }
+
+    while (auto message = WebSocket::read(subscriber.Incoming))
+    {
+        if (subscriber.Closing) continue; // nothing is answered after the close frame
+
+        if (message->Opcode == WebSocket::OPCODE_PING)
+        {
+            queue(subscriber, WebSocket::OPCODE_PONG, message->Payload);
+        }
+        else if (message->Opcode == WebSocket::OPCODE_CLOSE)
+        {
+            // echoes the status code
+            queue(subscriber, WebSocket::OPCODE_CLOSE, message->Payload.substr(0, 2));
+        }
+    }
+    return true;
+}
+
+bool imp::server::PathToStreamer::flush(Subscriber & subscriber)
+{
+    auto & outgoing{subscriber.Outgoing};
+    size_t written{0};
+    while (written < outgoing.size())
+    {
+        const auto WRITTEN{subscriber.Connection.object->writeSimple(
+            outgoing.data() + written, static_cast<v_buff_size>(outgoing.size() - written))};
+        if (WRITTEN == oatpp::IOError::RETRY_READ || WRITTEN == oatpp::IOError::RETRY_WRITE ||
+            WRITTEN == 0)
+            break;
+        if (WRITTEN < 0) return false;
+        written += static_cast<size_t>(WRITTEN);
+    }
+
+    outgoing.erase(0, written);
+    if (written || outgoing.empty()) subscriber.Written = time::Timer();
+    return subscriber.Written.elapsed() < PATH_TO_STREAM_WRITE_TIMEOUT;
+}
+
+void imp::server::PathToStreamer::queue(Subscriber & subscriber, const uint8_t OPCODE,
+                                        const std::string & payload)
+{
+    if (subscriber.Outgoing.empty()) subscriber.Written = time::Timer();
+    subscriber.Outgoing += WebSocket::frame(OPCODE, payload);
+    subscriber.Closing |= OPCODE == WebSocket::OPCODE_CLOSE;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "oatpp/network/ConnectionHandler.hpp"
+
+#include "imp/Settings.hpp"
+#include "imp/time/Timer.hpp"
+
+namespace imp::server
+{
+
+/**
+ * @brief Pushes the progress of path-to tasks to WebSocket connections upgraded by
+ * /path-to-stream. A single thread serves all subscribers every PATH_TO_STREAM_INTERVAL and
+ * never blocks: connections are non-blocking, each one buffers its unwritten frames (at most
+ * one progress frame, unchanged or superseded progress is not queued) and is dropped once a
+ * write stalls for PATH_TO_STREAM_WRITE_TIMEOUT. Pings are answered, a close frame of the
+ * client is echoed. The last frame of a finished task (the path) is produced off the streaming
+ * thread, the connection is closed after it.
+ */
+class PathToStreamer : public oatpp::network::ConnectionHandler
+{
+    /////////
+    // nested
+    /////////
+public:
+    /**
+     * @brief Progress frame of a task, never blocks. Last closes the connection after the
+     * frame (e.g. unknown task), Finished requests the path from the ResultSource instead.
+     */
+    struct Frame
+    {
+        std::string Payload;
+        bool Last{false};
+        bool Finished{false};
+    };
+    using FrameSource = std::function<Frame(const int32_t REQUEST_ID)>;
+    using ResultSource = std::function<std::future<std::string>(const int32_t REQUEST_ID)>;
+
+private:
+    struct Subscriber
+    {
+        oatpp::provider::ResourceHandle<oatpp::data::stream::IOStream> Connection;
+        int32_t RequestID{0};
+        std::string Last;     // unchanged progress is not sent again
+        std::string Outgoing; // encoded frames not written yet
+        std::string Incoming; // received bytes not decoded yet
+        time::Timer Written;  // last write progress (or empty buffer)
+        std::optional<std::future<std::string>> Result; // last frame in production
+        bool Closing{false};  // close frame queued, dropped once it is written
+    };
+
+    /////////
+    // data
+    /////////
+private:
+    FrameSource _source;
+    ResultSource _result;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<Subscriber> _subscribers;
+    bool _running{true};
+
+    std::thread _worker;
+
+    /////////
+    // constructors
+    /////////
+public:
+    PathToStreamer(FrameSource source, ResultSource result);
+    ~PathToStreamer() override;
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Subscribes the upgraded connection to the task given by the "path_to_request_id"
+     * parameter.
+     */
+    void handleConnection(
+        const oatpp::provider::ResourceHandle<oatpp::data::stream::IOStream> & connection,
+        const std::shared_ptr<const ParameterMap> & params) override;
+
+    void stop() override;
+
+private:
+    void run();
+
+    /**
+     * @brief Advances the subscriber by one step, returns false once it is to be dropped.
+     */
+    bool serve(Subscriber & subscriber);
+
+    /**
+     * @brief Decodes the received frames and answers control frames, returns false if the
+     * client is gone or misbehaves.
+     */
+    static bool receive(Subscriber & subscriber);
+
+    /**
+     * @brief Writes as much of the buffered frames as the connection takes, returns false if
+     * the client is gone or stalled for PATH_TO_STREAM_WRITE_TIMEOUT.
+     */
+    static bool flush(Subscriber & subscriber);
+
+    static void queue(Subscriber & subscriber, const uint8_t OPCODE, const std::string & payload);
+};
+
+} // namespace imp::server
@@ -1,12 +1,53 @@
 #include "imp/server/ServerController.hpp"
+
+#include <filesystem>
+
 #include "imp/WorldTree.hpp"
+#include "imp/io/RequestLog.hpp"
+#include "imp/io/Snapshot.hpp"
+#include "imp/metrics/Metrics.hpp"
+#include "imp/server/BinaryCodec.hpp"
+#include "imp/server/WebSocket.hpp"
 #include "oatpp/parser/json/mapping/ObjectMapper.hpp"
 
+namespace
+{
+
+// resolves a client given snapshot name inside SNAPSHOT_DIRECTORY, only plain basenames
+std::optional<std::filesystem::path> snapshotPath(const oatpp::String & filename)
+{
+    if (!filename) return std::nullopt;
+
+    const std::string NAME{*filename};
+    if (NAME.empty() || NAME == "." || NAME == ".." ||
+        NAME.find_first_of(std::string("/\\:\0", 4)) != std::string::npos)
+        return std::nullopt;
+
+    return std::filesystem::path(SNAPSHOT_DIRECTORY) / NAME;
+}
+
+#ifdef RECORD_REQUESTS
+
+// the /create-bin body of an object (the created id is appended by the caller)
+void encodeCreate(imp::io::BinaryWriter & writer, const bool MOVABLE,
+                  const std::vector<fcl::Vector3f> & vertices,
+                  const std::vector<fcl::Triangle> & triangles,
+                  const imp::Configuration & transform)
+{
+    writer.write<uint8_t>(MOVABLE);
+    imp::server::BinaryCodec::write(writer, transform);
+    imp::server::BinaryCodec::write(writer, vertices, triangles);
+}
+#endif
+
+} // namespace
+
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::createIMPL(
     const imp::server::ObjectCreationRequest::Wrapper & req_dto)
 {
     OATPP_LOGI("REQUEST ", " /create")
+    auto activity{_grower.activity()};
 
 #ifdef DUMP_REQUESTS
 
@@ -27,6 +68,132 @@ imp::server::ServerController::createIMPL(
 
 #endif
 
+    ObjectManager::Upload upload;
+    if (auto error = readUpload(req_dto, upload)) return error;
+
+    if (req_dto->build_async)
+    {
+        const bool MOVABLE{upload.Movable};
+        std::vector<ObjectManager::Upload> uploads;
+        uploads.emplace_back(std::move(upload));
+        const size_t ID{addAsync(std::move(uploads)).front()};
+
+        auto res_dto = ObjectCreationResult::createShared();
+        res_dto->movable = MOVABLE;
+        res_dto->id = ID;
+        res_dto->ready = false;
+
+        std::stringstream ss;
+        ss << " /create | Building object with ID = " << ID << " MOVABLE = " << MOVABLE;
+        OATPP_LOGI("RESULT ", ss.str().c_str())
+
+        return createDtoResponse(Status::CODE_202, res_dto);
+    }
+
+    return createIMPL(upload.Movable, upload.Vertices, upload.Triangles, upload.Transform);
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::create_bulkIMPL(
+    const imp::server::ObjectsCreationRequest::Wrapper & req_dto)
+{
+    OATPP_LOGI("REQUEST ", " /create-bulk")
+    auto activity{_grower.activity()};
+
+    if (!req_dto->objects) return createResponse(Status::CODE_400, "No objects given!");
+
+    // nothing is reserved unless every object is valid
+    std::vector<ObjectManager::Upload> uploads(req_dto->objects->size());
+    auto objects_begin = req_dto->objects->begin();
+    for (auto & upload : uploads)
+    {
+        if (auto error = readUpload(*(objects_begin++), upload)) return error;
+    }
+
+    std::vector<bool> movables(uploads.size());
+    for (size_t i = 0; i < uploads.size(); ++i) movables[i] = uploads[i].Movable;
+    const auto IDS{addAsync(std::move(uploads))};
+
+    auto res_dto = ObjectsCreationResult::createShared();
+    res_dto->objects = oatpp::List<oatpp::Object<ObjectCreationResult>>::createShared();
+    for (size_t i = 0; i < IDS.size(); ++i)
+    {
+        auto object_dto = ObjectCreationResult::createShared();
+        object_dto->movable = bool(movables[i]);
+        object_dto->id = IDS[i];
+        object_dto->ready = false;
+        res_dto->objects->emplace_back(object_dto);
+    }
+
+    std::stringstream ss;
+    ss << " /create-bulk | Building " << IDS.size() << " objects";
+    OATPP_LOGI("RESULT ", ss.str().c_str())
+
+    return createDtoResponse(Status::CODE_202, res_dto);
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::create_statusIMPL(
+    const imp::server::ObjectStatusRequest::Wrapper & req_dto)
+{
+    OATPP_LOGV("REQUEST ", " /create-status")
+
+    if (!req_dto->id || *req_dto->id < 0)
+        return createResponse(Status::CODE_400, "Invalid arguments!");
+
+    const bool MOVABLE{req_dto->movable};
+    const char * state{"missing"};
+    switch (_manager.state(MOVABLE, size_t(*req_dto->id)))
+    {
+    case ObjectManager::ObjectState::Pending:
+        state = "pending";
+        break;
+    case ObjectManager::ObjectState::Ready:
+        state = "ready";
+        break;
+    default:
+        break;
+    }
+
+    auto res_dto = ObjectStatusResult::createShared();
+    res_dto->movable = MOVABLE;
+    res_dto->id = req_dto->id;
+    res_dto->state = state;
+    return createDtoResponse(Status::CODE_200, res_dto);
+}
+
+std::vector<size_t>
+imp::server::ServerController::addAsync(std::vector<ObjectManager::Upload> uploads)
+{
+#ifdef RECORD_REQUESTS
+    time::Timer timer;
+    std::vector<io::BinaryWriter> records(uploads.size());
+    for (size_t i = 0; i < uploads.size(); ++i)
+        encodeCreate(records[i], uploads[i].Movable, uploads[i].Vertices, uploads[i].Triangles,
+                     uploads[i].Transform);
+#endif
+
+    auto ids{_manager.addAsync(std::move(uploads))};
+
+#ifdef RECORD_REQUESTS
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        records[i].write<uint64_t>(ids[i]);
+        io::RequestLog::get().append(io::RequestLog::Type::Create, timer.elapsed(),
+                                     records[i].buffer());
+    }
+#endif
+
+    return ids;
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::readUpload(
+    const imp::server::ObjectCreationRequest::Wrapper & req_dto, ObjectManager::Upload & upload)
+{
+    if (!req_dto || !req_dto->vertices || !req_dto->triangles)
+        return createResponse(Status::CODE_400, "Invalid arguments!");
+
     fcl::Quaternionf rotation;
     rotation.w() = req_dto->rotation_w;
     rotation.x() = req_dto->rotation_x;
@@ -45,31 +212,73 @@ imp::server::ServerController::createIMPL(
         return createResponse(Status::CODE_400, "Invalid number of vertices points (x, y, z).");
 
     auto vertices_begin = vertices->begin();
-    std::vector<fcl::Vector3f> vertices_Vector3f(vertices->size() / 3);
-    for (size_t i = 0; i < vertices_Vector3f.size(); ++i)
+    upload.Vertices.resize(vertices->size() / 3);
+    for (size_t i = 0; i < upload.Vertices.size(); ++i)
     {
-        vertices_Vector3f[i].x() = *(vertices_begin++);
-        vertices_Vector3f[i].y() = *(vertices_begin++);
-        vertices_Vector3f[i].z() = *(vertices_begin++);
+        upload.Vertices[i].x() = *(vertices_begin++);
+        upload.Vertices[i].y() = *(vertices_begin++);
+        upload.Vertices[i].z() = *(vertices_begin++);
     }
 
     if (triangles->size() % 3 != 0)
         return createResponse(Status::CODE_400, "Invalid number of triangle indices (a, b, c).");
 
-    std::vector<fcl::Triangle> triangles_Triangle(triangles->size() / 3);
+    upload.Triangles.resize(triangles->size() / 3);
     auto triangles_begin = triangles->begin();
-    for (size_t i = 0; i < triangles_Triangle.size(); ++i)
+    for (size_t i = 0; i < upload.Triangles.size(); ++i)
     {
-        triangles_Triangle[i][0] = static_cast<size_t>(*(triangles_begin++));
-        triangles_Triangle[i][1] = static_cast<size_t>(*(triangles_begin++));
-        triangles_Triangle[i][2] = static_cast<size_t>(*(triangles_begin++));
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const int32_t INDEX{*(triangles_begin++)};
+            if (INDEX < 0 || size_t(INDEX) >= upload.Vertices.size())
+                return createResponse(Status::CODE_400, "Triangle index out of range.");
+            upload.Triangles[i][k] = static_cast<size_t>(INDEX);
+        }
     }
 
-    auto id = _manager.add(req_dto->movable, vertices_Vector3f, triangles_Triangle,
-                           Configuration{position, rotation});
+    upload.Movable = req_dto->movable;
+    upload.Transform = Configuration{position, rotation};
+    return nullptr;
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::create_binIMPL(const oatpp::String & body)
+{
+    OATPP_LOGI("REQUEST ", " /create-bin")
+    auto activity{_grower.activity()};
+
+    io::BinaryReader reader(body->data(), body->size());
+    uint8_t movable{0};
+    Configuration transform;
+    std::vector<fcl::Vector3f> vertices;
+    std::vector<fcl::Triangle> triangles;
+    if (!BinaryCodec::readHeader(reader) || !reader.read(movable) ||
+        !BinaryCodec::read(reader, transform) || !BinaryCodec::read(reader, vertices, triangles))
+        return createResponse(Status::CODE_400, "Invalid binary argument!");
+
+    return createIMPL(bool(movable), vertices, triangles, transform);
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::createIMPL(const bool MOVABLE,
+                                          std::vector<fcl::Vector3f> & vertices,
+                                          std::vector<fcl::Triangle> & triangles,
+                                          const Configuration & transform)
+{
+#ifdef RECORD_REQUESTS
+    io::RequestLog::Entry entry(io::RequestLog::Type::Create);
+    encodeCreate(entry.payload(), MOVABLE, vertices, triangles, transform);
+#endif
+
+    auto id = _manager.add(MOVABLE, vertices, triangles, transform);
+
+#ifdef RECORD_REQUESTS
+    entry.payload().write<uint64_t>(id);
+#endif
     auto res_dto = ObjectCreationResult::createShared();
-    res_dto->movable = req_dto->movable;
+    res_dto->movable = MOVABLE;
     res_dto->id = id;
+    res_dto->ready = true;
 
     std::stringstream ss;
     ss << " /create | Created object with ID = " << id << " MOVABLE = " << res_dto->movable;
@@ -82,6 +291,7 @@ std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::collidesIMPL(const imp::server::CollisionRequest::Wrapper & req_dto)
 {
     OATPP_LOGV("REQUEST ", " /collides")
+    auto activity{_grower.activity()};
 
 #ifdef DUMP_REQUESTS
 
@@ -121,8 +331,16 @@ imp::server::ServerController::collidesIMPL(const imp::server::CollisionRequest:
     position.y() = req_dto->position_y;
     position.z() = req_dto->position_z;
 
+    const Configuration CONFIGURATION{position, rotation};
+
+#ifdef RECORD_REQUESTS
+    io::RequestLog::Entry entry(io::RequestLog::Type::Collides);
+    entry.payload().write<int32_t>(MOVABLE_ID);
+    BinaryCodec::write(entry.payload(), std::vector<Configuration>{CONFIGURATION});
+#endif
+
     auto res_dto = CollisionResult::createShared();
-    res_dto->is_colliding = _manager.collides(MOVABLE_ID, Configuration{position, rotation});
+    res_dto->is_colliding = _manager.collides(MOVABLE_ID, CONFIGURATION);
 
     return createDtoResponse(Status::CODE_200, res_dto);
 }
@@ -131,6 +349,8 @@ std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::collides_anyIMPL(
     const imp::server::MultipleCollisionRequest::Wrapper & req_dto)
 {
+    auto activity{_grower.activity()};
+
     const auto MOVABLE_ID = req_dto->movable_id;
 
     OATPP_LOGV("REQUEST ", " /collides-any")
@@ -154,12 +374,6 @@ imp::server::ServerController::collides_anyIMPL(
 
 #endif
 
-    if (!_manager.hasMovable(MOVABLE_ID))
-    {
-        OATPP_LOGE("REQUEST ", " /collides-any | Collision request with invalid id.")
-        return createResponse(Status::CODE_400, "Invalid JSON argument! ID does not exist!");
-    }
-
     auto rotation_w = req_dto->rotation_w.get();
     auto rotation_x = req_dto->rotation_x.get();
     auto rotation_y = req_dto->rotation_y.get();
@@ -201,6 +415,41 @@ imp::server::ServerController::collides_anyIMPL(
         transforms.emplace_back(Configuration{position, rotation});
     }
 
+    return collides_anyIMPL(MOVABLE_ID, transforms);
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::collides_any_binIMPL(const oatpp::String & body)
+{
+    OATPP_LOGV("REQUEST ", " /collides-any-bin")
+    auto activity{_grower.activity()};
+
+    io::BinaryReader reader(body->data(), body->size());
+    int32_t movable_id{0};
+    std::vector<Configuration> transforms;
+    if (!BinaryCodec::readHeader(reader) || !reader.read(movable_id) ||
+        !BinaryCodec::read(reader, transforms))
+        return createResponse(Status::CODE_400, "Invalid binary argument!");
+
+    return collides_anyIMPL(movable_id, transforms);
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::collides_anyIMPL(const int32_t MOVABLE_ID,
+                                                const std::vector<Configuration> & transforms)
+{
+    if (MOVABLE_ID < 0 || !_manager.hasMovable(MOVABLE_ID))
+    {
+        OATPP_LOGE("REQUEST ", " /collides-any | Collision request with invalid id.")
+        return createResponse(Status::CODE_400, "Invalid JSON argument! ID does not exist!");
+    }
+
+#ifdef RECORD_REQUESTS
+    io::RequestLog::Entry entry(io::RequestLog::Type::CollidesAny);
+    entry.payload().write<int32_t>(MOVABLE_ID);
+    BinaryCodec::write(entry.payload(), transforms);
+#endif
+
     int collision_count = 0;
 #pragma omp parallel for reduction(+ : collision_count)
     for (int i = 0; i < transforms.size(); ++i)
@@ -215,6 +464,8 @@ std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::new_local_closestIMPL(
     const imp::server::NewLocalClosestRequest::Wrapper & req_dto)
 {
+    auto activity{_grower.activity()};
+
     const auto MOVABLE_ID = req_dto->movable_id;
 
     OATPP_LOGV("REQUEST ", " /new-local-closest")
@@ -303,6 +554,8 @@ std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::is_collision_free_pathIMPL(
     const imp::server::NewLocalClosestRequest::Wrapper & req_dto)
 {
+    auto activity{_grower.activity()};
+
     const auto MOVABLE_ID = req_dto->movable_id;
 
     OATPP_LOGV("REQUEST ", " /is-collision-free-path")
@@ -360,10 +613,150 @@ imp::server::ServerController::is_collision_free_pathIMPL(
     return createDtoResponse(Status::CODE_200, res_dto);
 }
 
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::batchIMPL(const imp::server::BatchRequest::Wrapper & req_dto)
+{
+    auto activity{_grower.activity()};
+
+    OATPP_LOGV("REQUEST ", " /batch")
+
+#ifdef DUMP_REQUESTS
+
+    {
+        std::lock_guard<std::mutex> guard(_dump_mutex);
+
+        std::stringstream filename;
+        filename << "request_" << _dump_counter << "_batch.json";
+
+        std::ofstream fout(filename.str(), std::ofstream::out);
+
+        auto jsonObjectMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+        oatpp::String json = jsonObjectMapper->writeToString(req_dto);
+        fout << json.get()->c_str();
+
+        _dump_counter++;
+    }
+
+#endif
+
+    if (!req_dto->operations)
+        return createResponse(Status::CODE_400, "Invalid JSON argument! No operations!");
+
+    enum class Type
+    {
+        Invalid,
+        Collides,
+        IsCollisionFreePath,
+        NewLocalClosest
+    };
+
+    struct Operation
+    {
+        Type OperationType{Type::Invalid};
+        size_t MovableID{0};
+        Configuration Start, End;
+
+        bool Colliding{false};
+        std::pair<bool, Configuration> Closest{false, Configuration()};
+    };
+
+    // absent pose fields keep their identity value
+    auto value = [](const oatpp::Float32 & field, const float DEFAULT) {
+        return field ? static_cast<float>(field) : DEFAULT;
+    };
+
+    // decode on the request thread, the DTOs are not touched in parallel
+    std::vector<Operation> operations(req_dto->operations->size());
+    {
+        size_t i{0};
+        for (const auto & op_dto : *req_dto->operations)
+        {
+            auto & operation{operations[i++]};
+            if (!op_dto || !op_dto->type || !op_dto->movable_id || *op_dto->movable_id < 0 ||
+                !_manager.hasMovable(*op_dto->movable_id))
+                continue;
+
+            if (op_dto->type == "collides")
+                operation.OperationType = Type::Collides;
+            else if (op_dto->type == "is-collision-free-path")
+                operation.OperationType = Type::IsCollisionFreePath;
+            else if (op_dto->type == "new-local-closest")
+                operation.OperationType = Type::NewLocalClosest;
+            operation.MovableID = static_cast<size_t>(*op_dto->movable_id);
+
+            operation.Start.Position = {value(op_dto->start_position_x, 0.0f),
+                                        value(op_dto->start_position_y, 0.0f),
+                                        value(op_dto->start_position_z, 0.0f)};
+            operation.Start.Rotation = {
+                value(op_dto->start_rotation_w, 1.0f), value(op_dto->start_rotation_x, 0.0f),
+                value(op_dto->start_rotation_y, 0.0f), value(op_dto->start_rotation_z, 0.0f)};
+            operation.End.Position = {value(op_dto->end_position_x, 0.0f),
+                                      value(op_dto->end_position_y, 0.0f),
+                                      value(op_dto->end_position_z, 0.0f)};
+            operation.End.Rotation = {
+                value(op_dto->end_rotation_w, 1.0f), value(op_dto->end_rotation_x, 0.0f),
+                value(op_dto->end_rotation_y, 0.0f), value(op_dto->end_rotation_z, 0.0f)};
+        }
+    }
+
+    // operations differ widely in cost, hand them out one by one
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t i = 0; i < static_cast<int64_t>(operations.size()); ++i)
+    {
+        auto & operation{operations[i]};
+        switch (operation.OperationType)
+        {
+            case Type::Collides:
+                operation.Colliding = _manager.collides(operation.MovableID, operation.Start);
+                break;
+            case Type::IsCollisionFreePath:
+                operation.Colliding = !_manager.isCollisionFreePath(
+                    operation.MovableID, operation.Start, operation.End);
+                break;
+            case Type::NewLocalClosest:
+                operation.Closest = _manager.newLocalClosest(operation.MovableID, operation.Start,
+                                                             operation.End, false);
+                break;
+            default: break;
+        }
+    }
+
+    auto res_dto = BatchResult::createShared();
+    res_dto->results = oatpp::List<oatpp::Object<BatchOperationResult>>::createShared();
+    for (const auto & operation : operations)
+    {
+        auto result = BatchOperationResult::createShared();
+        result->valid = operation.OperationType != Type::Invalid;
+        if (operation.OperationType == Type::Collides ||
+            operation.OperationType == Type::IsCollisionFreePath)
+        {
+            result->is_colliding = operation.Colliding;
+        }
+        else if (operation.OperationType == Type::NewLocalClosest)
+        {
+            // like /new-local-closest the start is returned if no sample was found
+            const auto & pose{operation.Closest.first ? operation.Closest.second
+                                                      : operation.Start};
+            result->successful = operation.Closest.first;
+            result->position_x = pose.Position.x();
+            result->position_y = pose.Position.y();
+            result->position_z = pose.Position.z();
+            result->rotation_w = pose.Rotation.w();
+            result->rotation_x = pose.Rotation.x();
+            result->rotation_y = pose.Rotation.y();
+            result->rotation_z = pose.Rotation.z();
+        }
+        res_dto->results->emplace_back(result);
+    }
+
+    return createDtoResponse(Status::CODE_200, res_dto);
+}
+
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::path_toIMPL(const imp::server::PathToRequest::Wrapper & req_dto)
 {
     OATPP_LOGI("REQUEST ", " /path-to")
+    auto activity{_grower.activity()};
 
 #ifdef DUMP_REQUESTS
 
@@ -385,6 +778,11 @@ imp::server::ServerController::path_toIMPL(const imp::server::PathToRequest::Wra
 #endif
 
     const auto MOVABLE_ID = req_dto->movable_id;
+    if (!MOVABLE_ID || *MOVABLE_ID < 0 || !_manager.hasMovable(*MOVABLE_ID))
+    {
+        OATPP_LOGE("REQUEST ", " /path-to | Path request with invalid id.")
+        return createResponse(Status::CODE_404, "Movable not found!");
+    }
 
     fcl::Quaternionf rrotation;
     rrotation.w() = req_dto->start_rotation_w;
@@ -430,77 +828,145 @@ imp::server::ServerController::path_toIMPL(const imp::server::PathToRequest::Wra
     auto position_y_begin{position_y->begin()};
     auto position_z_begin{position_z->begin()};
 
-    std::optional<std::pair<size_t, Configuration>> matchee;
-    fcl::Quaternionf rotation;
-    fcl::Vector3f position;
-    size_t counters = 0;
+    std::vector<Configuration> u_path(size);
     for (size_t i = 0; i < size; ++i)
     {
-        rotation.w() = *(rotation_w_begin++);
-        rotation.x() = *(rotation_x_begin++);
-        rotation.y() = *(rotation_y_begin++);
-        rotation.z() = *(rotation_z_begin++);
+        u_path[i].Rotation.w() = *(rotation_w_begin++);
+        u_path[i].Rotation.x() = *(rotation_x_begin++);
+        u_path[i].Rotation.y() = *(rotation_y_begin++);
+        u_path[i].Rotation.z() = *(rotation_z_begin++);
+
+        u_path[i].Position.x() = *(position_x_begin++);
+        u_path[i].Position.y() = *(position_y_begin++);
+        u_path[i].Position.z() = *(position_z_begin++);
+    }
 
-        position.x() = *(position_x_begin++);
-        position.y() = *(position_y_begin++);
-        position.z() = *(position_z_begin++);
+    return path_toIMPL(MOVABLE_ID, root_configuration, u_path,
+                       req_dto->priority ? *req_dto->priority : 0,
+                       req_dto->client ? *req_dto->client : std::string(), std::move(activity));
+}
 
-        Configuration configuration{position, rotation};
-        if (!_manager.collides(MOVABLE_ID, configuration))
-        {
-            if (++counters == EST_MIN_MATCHEE_SECTION)
-            {
-                matchee = std::make_pair(i, configuration);
-                break;
-            }
-        }
-        else
-        {
-            counters = 0;
-        }
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_to_binIMPL(const oatpp::String & body)
+{
+    OATPP_LOGI("REQUEST ", " /path-to-bin")
+    auto activity{_grower.activity()};
+
+    io::BinaryReader reader(body->data(), body->size());
+    int32_t movable_id{0};
+    Configuration root_configuration;
+    std::vector<Configuration> u_path;
+    if (!BinaryCodec::readHeader(reader) || !reader.read(movable_id) ||
+        !BinaryCodec::read(reader, root_configuration) || !BinaryCodec::read(reader, u_path))
+        return createResponse(Status::CODE_400, "Invalid binary argument!");
+
+    if (movable_id < 0 || !_manager.hasMovable(movable_id))
+        return createResponse(Status::CODE_400, "Invalid binary argument! ID does not exist!");
+
+    if (_manager.collides(movable_id, root_configuration))
+        OATPP_LOGE("ERROR", "Initial configurations collide!");
+
+    return path_toIMPL(movable_id, root_configuration, u_path, 0, std::string(),
+                       std::move(activity));
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_toIMPL(const int32_t MOVABLE_ID,
+                                           const Configuration & root_configuration,
+                                           const std::vector<Configuration> & u_path,
+                                           const int32_t PRIORITY, const std::string & client,
+                                           RoadmapGrower::Activity && activity)
+{
+    // the id is known up front, all spans of the request (including the handler's span, see
+    // offload) are attributed to it
+    const int32_t TASK_ID{_scheduler.reserve()};
+    time::attribute(TASK_ID);
+
+    // the record is handed to the scheduler, its duration ends when the result is taken
+    std::shared_ptr<void> record;
+#ifdef RECORD_REQUESTS
+    {
+        auto entry{std::make_shared<io::RequestLog::Entry>(io::RequestLog::Type::PathTo)};
+        entry->payload().write<int32_t>(MOVABLE_ID);
+        BinaryCodec::write(entry->payload(), root_configuration);
+        BinaryCodec::write(entry->payload(), u_path);
+        record = std::move(entry);
     }
+#endif
 
-    auto res_dto = PathToResult::createShared();
-    if (!matchee.has_value())
+    const size_t size{u_path.size()};
+
+    time::Span phase("path-to.matchees");
+    auto selection{_manager.selectMatchees(MOVABLE_ID, u_path)};
+    const auto matchees{std::move(selection.first)};
+    const bool COLLISION_FREE_MATCHEE{selection.second};
+
+    if (COLLISION_FREE_MATCHEE)
     {
-        // res_dto->successful = false;
-        // res_dto->path_to_request_id = 0;
-        // return createDtoResponse(Status::CODE_200, res_dto);
-        // solving phase => start task
+        std::vector<Configuration> goals;
+        for (const auto & matchee : matchees) goals.emplace_back(matchee.second);
+        _grower.hint(MOVABLE_ID, goals);
+    }
 
-        matchee = std::make_pair(size_t(0), Configuration{position, rotation});
+    std::stringstream ss;
+    ss << " /path-to | " << (COLLISION_FREE_MATCHEE ? matchees.size() : 0)
+       << " collision free matchees of " << size << " poses";
+    OATPP_LOGI("REQUEST ", ss.str().c_str())
+
+    // fast phase => answer from the explored roadmap (only collision free matchees are queried,
+    // a miss is a failed query)
+    phase.next("path-to.roadmap");
+    auto wtree{_manager.wtree(MOVABLE_ID)};
+    if (COLLISION_FREE_MATCHEE && wtree)
+    {
+        if (auto hit = wtree->roadmap(_manager, root_configuration, matchees))
+        {
+            OATPP_LOGI("REQUEST ", " /path-to | answered from the world tree")
+            metrics::add(metrics::Counter::RoadmapHits);
 
-        int32_t task_id = _path_to_counter++;
-        _path_to_tasks.insert({task_id, PathToTask{size_t(MOVABLE_ID), //
-                                                   std::async(std::launch::async, [=, this]() {
-                                                       this->_manager.est(MOVABLE_ID)->stop();
-                                                       return this->_manager.est(MOVABLE_ID)
-                                                           ->explore(root_configuration,
-                                                                     matchee.value(), false);
-                                                   })}});
+            _scheduler.publish(TASK_ID, size_t(MOVABLE_ID),
+                               std::make_pair(hit->MatcheeIndex, std::move(hit->Path)), hit->Node,
+                               std::move(record));
 
-        res_dto->successful = true;
-        res_dto->path_to_request_id = task_id;
+            auto res_dto = PathToResult::createShared();
+            res_dto->successful = true;
+            res_dto->path_to_request_id = TASK_ID;
 
-        return createDtoResponse(Status::CODE_200, res_dto);
+            return createDtoResponse(Status::CODE_200, res_dto);
+        }
+        metrics::add(metrics::Counter::RoadmapMisses);
     }
-    else
+
+    phase.next("path-to.submit");
+
+    // solving phase => queue task, the activity is held until the exploration returns (the job
+    // has to be copyable)
+    auto held{std::make_shared<RoadmapGrower::Activity>(std::move(activity))};
+    const bool QUEUED{_scheduler.submit(
+        TASK_ID, size_t(MOVABLE_ID), PRIORITY, client,
+        [=, this, held = std::move(held)](
+            const CancellationToken & cancellation) -> PathToScheduler::Result {
+            // the scheduler runs one job per movable at a time, the EST is not shared. It is
+            // joined right away, before the next job of the movable reuses it
+            auto est{this->_manager.est(MOVABLE_ID)};
+            if (!est) return {-1, {}}; // removed meanwhile
+            auto result{est->explore(root_configuration, matchees, COLLISION_FREE_MATCHEE,
+                                     EST_MAX_EXPLORATION_RUNTIME, &cancellation)};
+            if (!cancellation.cancelled()) path_to_join(size_t(MOVABLE_ID), *est);
+            return result;
+        },
+        std::move(record))};
+    if (!QUEUED)
     {
-        // solving phase => start task
-        int32_t task_id = _path_to_counter++;
-        _path_to_tasks.insert({task_id, PathToTask{size_t(MOVABLE_ID), //
-                                                   std::async(std::launch::async, [=, this]() {
-                                                       this->_manager.est(MOVABLE_ID)->stop();
-                                                       return this->_manager.est(MOVABLE_ID)
-                                                           ->explore(root_configuration,
-                                                                     matchee.value());
-                                                   })}});
+        OATPP_LOGW("REQUEST ", " /path-to | saturated, request shed")
+        return createResponse(Status::CODE_503, "Too many pending explorations, retry later!");
+    }
 
-        res_dto->successful = true;
-        res_dto->path_to_request_id = task_id;
+    auto res_dto = PathToResult::createShared();
+    res_dto->successful = true;
+    res_dto->path_to_request_id = TASK_ID;
 
-        return createDtoResponse(Status::CODE_200, res_dto);
-    }
+    return createDtoResponse(Status::CODE_200, res_dto);
 }
 
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
@@ -528,14 +994,11 @@ imp::server::ServerController::path_to_statusIMPL(
 
 #endif
 
-    bool finished = false;
-
-    if (_path_to_tasks.contains(req_dto->path_to_request_id))
+    if (auto status = _scheduler.status(req_dto->path_to_request_id))
     {
         auto res_dto = PathToStatusResult::createShared();
         res_dto->path_to_request_id = req_dto->path_to_request_id;
-        res_dto->finished = (_path_to_tasks[req_dto->path_to_request_id].Future.wait_for(0s) ==
-                             std::future_status::ready);
+        res_dto->finished = status->second;
         return createDtoResponse(Status::CODE_200, res_dto);
     }
     else
@@ -569,14 +1032,17 @@ imp::server::ServerController::path_to_abortIMPL(
 
 #endif
 
-    if (_path_to_tasks.contains(req_dto->path_to_request_id))
-    {
-        _manager.est(_path_to_tasks[req_dto->path_to_request_id].ID)->stop();
-        std::this_thread::sleep_for(100ms);
-        _path_to_tasks.erase(req_dto->path_to_request_id);
-    }
+    // a queued task is just dropped, a running exploration is cancelled
+    return path_to_abort_pollIMPL(req_dto->path_to_request_id, false);
+}
 
-    return createResponse(Status::CODE_200, "OK");
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_to_abort_pollIMPL(const int32_t REQUEST_ID,
+                                                      const bool EXPIRED)
+{
+    if (_scheduler.abort(REQUEST_ID)) return createResponse(Status::CODE_200, "OK");
+    if (EXPIRED) return createResponse(Status::CODE_202, "Abort pending!");
+    return nullptr;
 }
 
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
@@ -584,6 +1050,7 @@ imp::server::ServerController::path_to_getIMPL(
     const imp::server::PathToGetRequest::Wrapper & req_dto)
 {
     OATPP_LOGI("REQUEST ", " /path-to-get")
+    auto activity{_grower.activity()};
 
 #ifdef DUMP_REQUESTS
 
@@ -604,63 +1071,227 @@ imp::server::ServerController::path_to_getIMPL(
 
 #endif
 
-    if (_path_to_tasks.contains(req_dto->path_to_request_id))
+    auto result_pair{path_to_take(req_dto->path_to_request_id)};
+    if (!result_pair.has_value()) return createResponse(Status::CODE_404, "Couldn't be found!");
+
+    auto res_dto = PathToGetResult::createShared();
+    auto & result = result_pair->second;
+
+    oatpp::List<oatpp::Float32> p_positions_x{oatpp::List<oatpp::Float32>::createShared()},
+        p_positions_y{oatpp::List<oatpp::Float32>::createShared()},
+        p_positions_z{oatpp::List<oatpp::Float32>::createShared()},
+        p_rotations_w{oatpp::List<oatpp::Float32>::createShared()},
+        p_rotations_x{oatpp::List<oatpp::Float32>::createShared()},
+        p_rotations_y{oatpp::List<oatpp::Float32>::createShared()},
+        p_rotations_z{oatpp::List<oatpp::Float32>::createShared()};
+
+    for (Configuration & config : result)
     {
-        auto result_pair = _path_to_tasks[static_cast<uint32_t>(req_dto->path_to_request_id)].Future.get();
-        auto res_dto = PathToGetResult::createShared();
-        auto & result = result_pair.second;
+        p_positions_x->emplace_back(config.Position.x());
+        p_positions_y->emplace_back(config.Position.y());
+        p_positions_z->emplace_back(config.Position.z());
+        p_rotations_w->emplace_back(config.Rotation.w());
+        p_rotations_x->emplace_back(config.Rotation.x());
+        p_rotations_y->emplace_back(config.Rotation.y());
+        p_rotations_z->emplace_back(config.Rotation.z());
+    }
 
-        oatpp::List<oatpp::Float32> p_positions_x{oatpp::List<oatpp::Float32>::createShared()},
-            p_positions_y{oatpp::List<oatpp::Float32>::createShared()},
-            p_positions_z{oatpp::List<oatpp::Float32>::createShared()},
-            p_rotations_w{oatpp::List<oatpp::Float32>::createShared()},
-            p_rotations_x{oatpp::List<oatpp::Float32>::createShared()},
-            p_rotations_y{oatpp::List<oatpp::Float32>::createShared()},
-            p_rotations_z{oatpp::List<oatpp::Float32>::createShared()};
+    res_dto->p_positions_x = p_positions_x;
+    res_dto->p_positions_y = p_positions_y;
+    res_dto->p_positions_z = p_positions_z;
+    res_dto->p_rotations_w = p_rotations_w;
+    res_dto->p_rotations_x = p_rotations_x;
+    res_dto->p_rotations_y = p_rotations_y;
+    res_dto->p_rotations_z = p_rotations_z;
 
-        for (Configuration & config : result)
-        {
-            p_positions_x->emplace_back(config.Position.x());
-            p_positions_y->emplace_back(config.Position.y());
-            p_positions_z->emplace_back(config.Position.z());
-            p_rotations_w->emplace_back(config.Rotation.w());
-            p_rotations_x->emplace_back(config.Rotation.x());
-            p_rotations_y->emplace_back(config.Rotation.y());
-            p_rotations_z->emplace_back(config.Rotation.z());
-        }
+    res_dto->matchee_index = result_pair->first;
 
-        res_dto->p_positions_x = p_positions_x;
-        res_dto->p_positions_y = p_positions_y;
-        res_dto->p_positions_z = p_positions_z;
-        res_dto->p_rotations_w = p_rotations_w;
-        res_dto->p_rotations_x = p_rotations_x;
-        res_dto->p_rotations_y = p_rotations_y;
-        res_dto->p_rotations_z = p_rotations_z;
+    return createDtoResponse(Status::CODE_200, res_dto);
+}
 
-        res_dto->matchee_index = result_pair.first;
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_to_get_binIMPL(
+    const imp::server::PathToGetRequest::Wrapper & req_dto)
+{
+    OATPP_LOGI("REQUEST ", " /path-to-get-bin")
+    auto activity{_grower.activity()};
+
+    auto result_pair{path_to_take(req_dto->path_to_request_id)};
+    if (!result_pair.has_value()) return createResponse(Status::CODE_404, "Couldn't be found!");
+
+    io::BinaryWriter writer;
+    BinaryCodec::writeHeader(writer);
+    writer.write<int64_t>(result_pair->first);
+    BinaryCodec::write(writer, result_pair->second);
+
+    const auto & buffer{writer.buffer()};
+    auto response{createResponse(
+        Status::CODE_200, oatpp::String(buffer.data(), static_cast<v_buff_size>(buffer.size())))};
+    response->putHeader(Header::CONTENT_TYPE, BinaryCodec::CONTENT_TYPE);
+    return response;
+}
 
-        _path_to_tasks.erase(req_dto->path_to_request_id);
+std::optional<std::pair<int64_t, std::vector<imp::Configuration>>>
+imp::server::ServerController::path_to_take(const int32_t REQUEST_ID)
+{
+    // the task holds the request log record until it returns
+    auto task{_scheduler.take(REQUEST_ID)};
+    if (!task.has_value()) return std::nullopt;
 
-        auto id = req_dto->movable_id;
-        if (!_manager.wtree(id)->join(*_manager.est(id)))
-        {
-            OATPP_LOGE("WorldTree ", " Unable to join EST!");
-        }
-        else 
-        {
-            OATPP_LOGI("WorldTree ", " Joined EST!");
-        }
+    // a roadmap answer moves the position, explorations were joined by their job
+    if (task->RoadmapNode.has_value())
+    {
+        auto wtree{_manager.wtree(task->MovableID)};
+        if (!wtree) return std::make_pair(int64_t(-1), std::vector<Configuration>());
+        wtree->moveTo(task->RoadmapNode.value());
+    }
+    return std::move(task->Value);
+}
 
-        return createDtoResponse(Status::CODE_200, res_dto);
+void imp::server::ServerController::path_to_join(const size_t MOVABLE_ID, EST & est)
+{
+    time::Span span("path-to.join");
+
+    const auto & statistics{est.statistics()};
+    std::stringstream ss;
+    ss << " /path-to | " << statistics.Iterations << " iterations, " << statistics.Accepted
+       << "/" << statistics.Candidates << " candidates accepted, " << statistics.NodesPerSecond
+       << " nodes/s";
+    OATPP_LOGI("EST ", ss.str().c_str())
+
+    auto wtree{_manager.wtree(MOVABLE_ID)};
+    if (!wtree) return; // removed meanwhile
+
+    if (!wtree->join(est))
+    {
+        OATPP_LOGE("WorldTree ", " Unable to join EST!");
+    }
+    else
+    {
+        std::stringstream ws;
+        ws << " Joined EST! " << wtree->size() << " nodes, " << wtree->memoryUsage() / 1024
+           << " KiB";
+        OATPP_LOGI("WorldTree ", ws.str().c_str());
+    }
+}
+
+imp::server::PathToStreamer::Frame
+imp::server::ServerController::path_to_frame(const int32_t REQUEST_ID)
+{
+    const auto & path_to_request_id{REQUEST_ID};
+
+    std::optional<size_t> movable;
+    bool finished{false};
+    if (auto status = _scheduler.status(REQUEST_ID))
+        std::tie(movable, finished) = status.value();
+
+    if (finished) return PathToStreamer::Frame{std::string(), true, true};
+
+    auto est{movable.has_value() ? _manager.est(movable.value()) : nullptr};
+    std::stringstream ss;
+    ss << "{";
+    if (!est)
+    {
+        ss << "\"type\":\"error\",";
+        JSON(path_to_request_id)
+        ss << "}";
+        return PathToStreamer::Frame{ss.str(), true};
     }
 
-    return createResponse(Status::CODE_404, "Couldn't be found!");
+    const auto Progress{est->progress()};
+    ss << "\"type\":\"progress\",";
+    JSOND(path_to_request_id)
+    JSON(Progress)
+    ss << "}";
+    return PathToStreamer::Frame{ss.str()};
+}
+
+std::string imp::server::ServerController::path_to_result(const int32_t REQUEST_ID)
+{
+    const auto & path_to_request_id{REQUEST_ID};
+
+    auto activity{_grower.activity()};
+    auto result_pair{path_to_take(REQUEST_ID)};
+
+    std::stringstream ss;
+    ss << "{";
+    if (!result_pair.has_value())
+    {
+        ss << "\"type\":\"error\",";
+        JSON(path_to_request_id)
+        ss << "}";
+        return ss.str();
+    }
+
+    const auto & MatcheeIndex{result_pair->first};
+    const auto & Path{result_pair->second};
+    ss << "\"type\":\"path\",";
+    JSOND(path_to_request_id)
+    JSOND(MatcheeIndex)
+    JSON(Path)
+    ss << "}";
+    return ss.str();
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_to_streamIMPL(const std::shared_ptr<IncomingRequest> & request)
+{
+    OATPP_LOGI("REQUEST ", " /path-to-stream")
+
+    auto key{request->getHeader("Sec-WebSocket-Key")};
+    auto id{request->getPathVariable("path_to_request_id")};
+    if (!key || !id) return createResponse(Status::CODE_400, "WebSocket handshake expected!");
+
+    auto response{oatpp::web::protocol::http::outgoing::Response::createShared(
+        Status::CODE_101, nullptr)};
+    response->putHeader("Upgrade", "websocket");
+    response->putHeader(Header::CONNECTION, Header::Value::CONNECTION_UPGRADE);
+    response->putHeader("Sec-WebSocket-Accept", WebSocket::acceptKey(*key));
+
+    auto params{std::make_shared<oatpp::network::ConnectionHandler::ParameterMap>()};
+    (*params)["path_to_request_id"] = id;
+    response->setConnectionUpgradeHandler(_streamer);
+    response->setConnectionUpgradeParameters(params);
+    return response;
+}
+
+std::future<std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>>
+imp::server::ServerController::offload(
+    const char * PATH,
+    std::function<std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>()> handler)
+{
+    return _workers.submit([PATH, handler = std::move(handler)]() {
+        time::TraceScope scope(time::Tracer::NO_REQUEST); // the handler may attribute the span
+        time::Span span(PATH);
+        time::Timer timer;
+        auto response{handler()};
+        metrics::Registry::get().request(PATH, timer.elapsed());
+        return response;
+    });
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_to_pollIMPL(
+    const imp::server::PathToGetRequest::Wrapper & req_dto, bool EXPIRED, bool & ready)
+{
+    auto status{_scheduler.status(req_dto->path_to_request_id)};
+    if (!status.has_value()) return createResponse(Status::CODE_404, "Couldn't be found!");
+
+    ready = status->second;
+    if (ready || !EXPIRED) return nullptr;
+
+    auto res_dto = PathToStatusResult::createShared();
+    res_dto->path_to_request_id = req_dto->path_to_request_id;
+    res_dto->finished = false;
+    return createDtoResponse(Status::CODE_200, res_dto);
 }
 
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::trashesIMPL(
     const imp::server::ObjectsTrashRequest::Wrapper & req_dto)
 {
+    auto activity{_grower.activity()};
+
     auto movables_begin = req_dto->movables->begin();
     const auto movables_end = req_dto->movables->end();
     auto ids_begin = req_dto->ids->begin();
@@ -685,20 +1316,38 @@ imp::server::ServerController::trashesIMPL(
 
 #endif
 
+#ifdef RECORD_REQUESTS
+    io::RequestLog::Entry entry(io::RequestLog::Type::Remove);
+    std::vector<uint8_t> removed_movables;
+    std::vector<uint64_t> removed_ids;
+#endif
+
     while (movables_begin != movables_end && ids_begin != ids_end)
     {
         bool movable = *(movables_begin++);
         size_t id = *(ids_begin++);
 
         _manager.remove(movable, id);
+
+#ifdef RECORD_REQUESTS
+        removed_movables.emplace_back(movable);
+        removed_ids.emplace_back(id);
+#endif
     }
 
+#ifdef RECORD_REQUESTS
+    entry.payload().write(removed_movables);
+    entry.payload().write(removed_ids);
+#endif
+
     return createResponse(Status::CODE_200, "OK!");
 }
 
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::movedIMPL(const imp::server::MovedRequest::Wrapper & req_dto)
 {
+    auto activity{_grower.activity()};
+
     Configuration start;
     start.Position.x() = req_dto->start_position_x;
     start.Position.y() = req_dto->start_position_y;
@@ -717,17 +1366,124 @@ imp::server::ServerController::movedIMPL(const imp::server::MovedRequest::Wrappe
     end.Rotation.z() = req_dto->end_rotation_z;
     end.Rotation.w() = req_dto->end_rotation_w;
 
-    auto & tree = _manager.wtree(req_dto->movable_id);
+#ifdef RECORD_REQUESTS
+    io::RequestLog::Entry entry(io::RequestLog::Type::Moved);
+    entry.payload().write<int32_t>(req_dto->movable_id);
+    BinaryCodec::write(entry.payload(), start);
+    BinaryCodec::write(entry.payload(), end);
+#endif
+
+    auto tree = _manager.wtree(req_dto->movable_id);
+    if (!tree) return createResponse(Status::CODE_404, "Couldn't be found!");
     if (!tree->moveFromToInsert(start, end))
         OATPP_LOGE("WorldTree ", " Unable to apply movement!");
     return createResponse(Status::CODE_200, "OK!");
 }
 
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::path_repairIMPL(
+    const imp::server::PathRepairRequest::Wrapper & req_dto)
+{
+    OATPP_LOGI("REQUEST ", " /path-repair")
+    auto activity{_grower.activity()};
+
+#ifdef DUMP_REQUESTS
+
+    {
+        std::lock_guard<std::mutex> guard(_dump_mutex);
+
+        std::stringstream filename;
+        filename << "request_" << _dump_counter << "_path-repair.json";
+
+        std::ofstream fout(filename.str(), std::ofstream::out);
+
+        auto jsonObjectMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+        oatpp::String json = jsonObjectMapper->writeToString(req_dto);
+        fout << json.get()->c_str();
+
+        _dump_counter++;
+    }
+
+#endif
+
+    const auto MOVABLE_ID = req_dto->movable_id;
+    if (!_manager.hasMovable(MOVABLE_ID))
+        return createResponse(Status::CODE_404, "Movable not found!");
+
+    auto size{req_dto->p_positions_x->size()};
+    if (size != req_dto->p_positions_y->size() || size != req_dto->p_positions_z->size() ||
+        size != req_dto->p_rotations_w->size() || size != req_dto->p_rotations_x->size() ||
+        size != req_dto->p_rotations_y->size() || size != req_dto->p_rotations_z->size())
+    {
+        OATPP_LOGE("REQUEST ", " /path-repair | Invalid JSON argument!");
+        return createResponse(Status::CODE_400, "Invalid JSON argument! Size mismatch!");
+    }
+
+    auto position_x_begin{req_dto->p_positions_x->begin()};
+    auto position_y_begin{req_dto->p_positions_y->begin()};
+    auto position_z_begin{req_dto->p_positions_z->begin()};
+    auto rotation_w_begin{req_dto->p_rotations_w->begin()};
+    auto rotation_x_begin{req_dto->p_rotations_x->begin()};
+    auto rotation_y_begin{req_dto->p_rotations_y->begin()};
+    auto rotation_z_begin{req_dto->p_rotations_z->begin()};
+
+    std::vector<Configuration> path(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        path[i].Position.x() = *(position_x_begin++);
+        path[i].Position.y() = *(position_y_begin++);
+        path[i].Position.z() = *(position_z_begin++);
+        path[i].Rotation.w() = *(rotation_w_begin++);
+        path[i].Rotation.x() = *(rotation_x_begin++);
+        path[i].Rotation.y() = *(rotation_y_begin++);
+        path[i].Rotation.z() = *(rotation_z_begin++);
+    }
+
+    time::Timer timer;
+    auto [successful, gaps, result] = _manager.repairPath(MOVABLE_ID, path);
+
+    std::stringstream ss;
+    ss << " /path-repair | " << gaps << " gaps " << (successful ? "repaired" : "not repaired")
+       << " in " << std::chrono::duration<float>(timer.elapsed()).count() << "s";
+    OATPP_LOGI("REQUEST ", ss.str().c_str())
+
+    auto res_dto = PathRepairResult::createShared();
+    res_dto->successful = successful;
+    res_dto->repaired_gaps = static_cast<int32_t>(successful ? gaps : 0);
+    res_dto->p_positions_x = oatpp::List<oatpp::Float32>::createShared();
+    res_dto->p_positions_y = oatpp::List<oatpp::Float32>::createShared();
+    res_dto->p_positions_z = oatpp::List<oatpp::Float32>::createShared();
+    res_dto->p_rotations_w = oatpp::List<oatpp::Float32>::createShared();
+    res_dto->p_rotations_x = oatpp::List<oatpp::Float32>::createShared();
+    res_dto->p_rotations_y = oatpp::List<oatpp::Float32>::createShared();
+    res_dto->p_rotations_z = oatpp::List<oatpp::Float32>::createShared();
+
+    for (const Configuration & config : result)
+    {
+        res_dto->p_positions_x->emplace_back(config.Position.x());
+        res_dto->p_positions_y->emplace_back(config.Position.y());
+        res_dto->p_positions_z->emplace_back(config.Position.z());
+        res_dto->p_rotations_w->emplace_back(config.Rotation.w());
+        res_dto->p_rotations_x->emplace_back(config.Rotation.x());
+        res_dto->p_rotations_y->emplace_back(config.Rotation.y());
+        res_dto->p_rotations_z->emplace_back(config.Rotation.z());
+    }
+
+    return createDtoResponse(Status::CODE_200, res_dto);
+}
+
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
 imp::server::ServerController::dumpwtIMPL(const imp::server::DumpRequest::Wrapper & req_dto)
 {
+    auto activity{_grower.activity()};
+
     auto id = req_dto->movable_id;
-    auto & WTree = _manager.wtree(id);
+    auto WTree = _manager.wtree(id);
+    if (!WTree) return createResponse(Status::CODE_404, "Couldn't be found!");
+
+    std::stringstream ws;
+    ws << " /dumpwt | " << WTree->size() << " nodes, " << WTree->memoryUsage() / 1024 << " KiB";
+    OATPP_LOGI("WorldTree ", ws.str().c_str());
 
     // construct filename
     std::ofstream ss;
@@ -740,4 +1496,86 @@ imp::server::ServerController::dumpwtIMPL(const imp::server::DumpRequest::Wrappe
     ss.close();
 
     return createResponse(Status::CODE_200, "OK!");
-}
\ No newline at end of file
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::snapshot_saveIMPL(
+    const imp::server::SnapshotRequest::Wrapper & req_dto)
+{
+    OATPP_LOGI("REQUEST ", " /snapshot-save")
+    auto path{snapshotPath(req_dto->filename)};
+    if (!path.has_value()) return createResponse(Status::CODE_400, "Invalid snapshot name!");
+
+    std::error_code error;
+    std::filesystem::create_directories(SNAPSHOT_DIRECTORY, error);
+
+    auto activity{_grower.activity()};
+
+    time::Timer timer;
+    if (!io::Snapshot::save(_manager, path->string()))
+        return createResponse(Status::CODE_500, "Unable to write snapshot!");
+
+    std::stringstream ss;
+    ss << " /snapshot-save | " << std::chrono::duration<float>(timer.elapsed()).count() << "s";
+    OATPP_LOGI("REQUEST ", ss.str().c_str())
+
+    return createResponse(Status::CODE_200, "OK");
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::snapshot_loadIMPL(
+    const imp::server::SnapshotRequest::Wrapper & req_dto)
+{
+    OATPP_LOGI("REQUEST ", " /snapshot-load")
+    auto path{snapshotPath(req_dto->filename)};
+    if (!path.has_value()) return createResponse(Status::CODE_400, "Invalid snapshot name!");
+
+    auto activity{_grower.activity()};
+
+    // running explorations reference the objects that are replaced
+    _scheduler.drain();
+
+    time::Timer timer;
+    if (!io::Snapshot::load(_manager, path->string()))
+        return createResponse(Status::CODE_400, "Unable to read snapshot!");
+
+    std::stringstream ss;
+    ss << " /snapshot-load | " << std::chrono::duration<float>(timer.elapsed()).count() << "s";
+    OATPP_LOGI("REQUEST ", ss.str().c_str())
+
+    return createResponse(Status::CODE_200, "OK");
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::scrape_metricsIMPL()
+{
+    const std::vector<metrics::Gauge> GAUGES{
+        {"imp_path_to_queued", "Path-to explorations waiting for a worker.",
+         double(_scheduler.queued())},
+        {"imp_path_to_running", "Path-to explorations being executed.",
+         double(_scheduler.running())},
+        {"imp_meshes", "Distinct meshes with a built model.", double(_manager.meshCount())},
+    };
+
+    std::stringstream ss;
+    metrics::Registry::get().render(ss, GAUGES);
+
+    auto response{createResponse(Status::CODE_200, ss.str())};
+    response->putHeader(Header::CONTENT_TYPE, "text/plain; version=0.0.4");
+    return response;
+}
+
+std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+imp::server::ServerController::traceIMPL(const imp::server::TraceRequest::Wrapper & req_dto)
+{
+    const int64_t REQUEST{!req_dto->path_to_request_id ? time::Tracer::NO_REQUEST
+                                                       : int64_t(*req_dto->path_to_request_id)};
+
+    std::stringstream ss;
+    if (!time::Tracer::get().write(ss, REQUEST))
+        return createResponse(Status::CODE_404, "No spans of this request buffered!");
+
+    auto response{createResponse(Status::CODE_200, ss.str())};
+    response->putHeader(Header::CONTENT_TYPE, "application/json");
+    return response;
+}
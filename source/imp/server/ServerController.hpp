@@ -1,9 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <exception>
 #include <functional>
 #include <future>
 #include <numeric>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 
@@ -13,13 +15,118 @@
 
 #include "imp/EST.hpp"
 #include "imp/ObjectManager.hpp"
+#include "imp/RoadmapGrower.hpp"
+#include "imp/io/RequestLog.hpp"
+#include "imp/metrics/Metrics.hpp"
 #include "imp/server/DTO.hpp"
+#include "imp/server/PathToScheduler.hpp"
+#include "imp/server/PathToStreamer.hpp"
+#include "imp/server/WorkerPool.hpp"
+#include "imp/time/Tracer.hpp"
 
 namespace imp::server
 {
 
 #include OATPP_CODEGEN_BEGIN(ApiController) ///< Begin Codegen
 
+/**
+ * @brief Members of a coroutine endpoint which runs a blocking handler on the worker pool
+ * (see ServerController::offload): offload() submits it, the coroutine then polls for the
+ * response every SERVER_BLOCKING_POLL_INTERVAL without occupying its processor.
+ */
+#define IMP_OFFLOADING(NAME)                                                                       \
+    std::future<std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>> _pending;         \
+                                                                                                   \
+    Action offload(const char * PATH,                                                              \
+                   std::function<std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>()>\
+                       handler)                                                                    \
+    {                                                                                              \
+        _pending = controller->offload(PATH, std::move(handler));                                  \
+        return yieldTo(&NAME::awaitResponse);                                                      \
+    }                                                                                              \
+                                                                                                   \
+    Action awaitResponse()                                                                         \
+    {                                                                                              \
+        if (_pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)               \
+            return _return(_pending.get());                                                        \
+        return waitRepeat(                                                                         \
+            std::chrono::duration_cast<std::chrono::microseconds>(SERVER_BLOCKING_POLL_INTERVAL)); \
+    }
+
+/**
+ * @brief Coroutine endpoint which reads the body DTO without blocking and answers with NAME##IMPL.
+ * The handler runs inline on an executor processor, so it has to be O(1) and must not wait
+ * (e.g. for RoadmapGrower::activity). Its duration is recorded per PATH.
+ */
+#define IMP_ENDPOINT_ASYNC(METHOD, PATH, NAME, DTO_TYPE)                                           \
+    ENDPOINT_ASYNC(METHOD, PATH, NAME)                                                             \
+    {                                                                                              \
+        ENDPOINT_ASYNC_INIT(NAME)                                                                  \
+                                                                                                   \
+        Action act() override                                                                      \
+        {                                                                                          \
+            return request                                                                         \
+                ->readBodyToDtoAsync<oatpp::Object<DTO_TYPE>>(                                     \
+                    controller->getDefaultObjectMapper())                                          \
+                .callbackTo(&NAME::respond);                                                       \
+        }                                                                                          \
+                                                                                                   \
+        Action respond(const oatpp::Object<DTO_TYPE> & req_dto)                                    \
+        {                                                                                          \
+            imp::time::Span span(PATH);                                                            \
+            imp::time::Timer timer;                                                                \
+            auto response{controller->NAME##IMPL(req_dto)};                                        \
+            imp::metrics::Registry::get().request(PATH, timer.elapsed());                          \
+            return _return(response);                                                              \
+        }                                                                                          \
+    };
+
+/**
+ * @brief Like IMP_ENDPOINT_ASYNC, but NAME##IMPL runs on the worker pool. For every handler
+ * which touches the scene, explores or waits.
+ */
+#define IMP_ENDPOINT_BLOCKING(METHOD, PATH, NAME, DTO_TYPE)                                        \
+    ENDPOINT_ASYNC(METHOD, PATH, NAME)                                                             \
+    {                                                                                              \
+        ENDPOINT_ASYNC_INIT(NAME)                                                                  \
+        IMP_OFFLOADING(NAME)                                                                       \
+                                                                                                   \
+        Action act() override                                                                      \
+        {                                                                                          \
+            return request                                                                         \
+                ->readBodyToDtoAsync<oatpp::Object<DTO_TYPE>>(                                     \
+                    controller->getDefaultObjectMapper())                                          \
+                .callbackTo(&NAME::respond);                                                       \
+        }                                                                                          \
+                                                                                                   \
+        Action respond(const oatpp::Object<DTO_TYPE> & req_dto)                                    \
+        {                                                                                          \
+            return offload(PATH, [c = controller, req_dto]() { return c->NAME##IMPL(req_dto); });  \
+        }                                                                                          \
+    };
+
+/**
+ * @brief Coroutine endpoint for binary bodies (see BinaryCodec), answers with NAME##IMPL on the
+ * worker pool.
+ */
+#define IMP_ENDPOINT_BLOCKING_BINARY(METHOD, PATH, NAME)                                           \
+    ENDPOINT_ASYNC(METHOD, PATH, NAME)                                                             \
+    {                                                                                              \
+        ENDPOINT_ASYNC_INIT(NAME)                                                                  \
+        IMP_OFFLOADING(NAME)                                                                       \
+                                                                                                   \
+        Action act() override                                                                      \
+        {                                                                                          \
+            return request->readBodyToStringAsync().callbackTo(&NAME::respond);                    \
+        }                                                                                          \
+                                                                                                   \
+        Action respond(const oatpp::String & body)                                                 \
+        {                                                                                          \
+            if (!body) return _return(controller->createResponse(Status::CODE_400, "No body!"));   \
+            return offload(PATH, [c = controller, body]() { return c->NAME##IMPL(body); });        \
+        }                                                                                          \
+    };
+
 /**
  * @brief Server controller for imp-server. This class manages routing.
  *
@@ -27,133 +134,449 @@ namespace imp::server
  */
 class ServerController : public oatpp::web::server::api::ApiController
 {
-    /////////
-    // nested
-    /////////
-private:
-    struct PathToTask
-    {
-        size_t ID;
-        std::future<std::pair<int64_t, std::vector<imp::Configuration>>> Future;
-    };
-
     /////////
     // data
     /////////
 private:
     imp::ObjectManager _manager;
+    imp::RoadmapGrower _grower{_manager}; // idle time roadmap growth (BACKGROUND_GROWTH)
 
-    std::atomic<int32_t> _path_to_counter{0};
-    std::unordered_map<int32_t, PathToTask> _path_to_tasks;
+    PathToScheduler _scheduler; // path-to tasks, bounded queue and registry
+    WorkerPool _workers{SERVER_BLOCKING_WORKERS}; // blocking handlers (see offload)
+    std::shared_ptr<PathToStreamer> _streamer;
 
     long long _dump_counter{0};
     std::mutex _dump_mutex;
 
 public:
     ServerController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
-        : oatpp::web::server::api::ApiController(objectMapper)
-    {}
+        : oatpp::web::server::api::ApiController(objectMapper),
+          _streamer{std::make_shared<PathToStreamer>(
+              [this](const int32_t REQUEST_ID) { return path_to_frame(REQUEST_ID); },
+              [this](const int32_t REQUEST_ID) {
+                  return _workers.submit(
+                      [this, REQUEST_ID]() { return path_to_result(REQUEST_ID); });
+              })}
+    {
+#ifdef RECORD_REQUESTS
+        const auto & log{io::RequestLog::get()};
+        if (!log.good())
+        {
+            OATPP_LOGE("RequestLog ", " %s", log.message().c_str())
+        }
+        else if (!log.message().empty())
+        {
+            OATPP_LOGW("RequestLog ", " %s", log.message().c_str())
+        }
+#endif
+    }
+
+    ~ServerController() { _streamer->stop(); }
+
+    /////////
+    // helpers
+    /////////
+public:
+    /**
+     * @brief Runs a blocking handler on the worker pool (see IMP_OFFLOADING), its span and
+     * duration are recorded per PATH.
+     */
+    std::future<std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>>
+    offload(const char * PATH,
+            std::function<std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>()>
+                handler);
+
+    /**
+     * @brief Status step of a waiting path retrieval, never blocks. Returns nullptr while the
+     * task is still exploring (or finished, ready is set then and the caller offloads the
+     * retrieval) and the status of the task once EXPIRED is set.
+     */
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_to_pollIMPL(const imp::server::PathToGetRequest::Wrapper & req_dto, bool EXPIRED,
+                     bool & ready);
+
+    /**
+     * @brief Takes the result of a finished path-to task, a roadmap answer moves the position
+     * of the world tree. nullopt if there is no such task, a failed result if the movable was
+     * removed meanwhile.
+     */
+    std::optional<std::pair<int64_t, std::vector<imp::Configuration>>>
+    path_to_take(const int32_t REQUEST_ID);
+
+    /**
+     * @brief Joins a finished exploration into the world tree of the movable (from the
+     * scheduler job, before another job of the movable reuses the EST).
+     */
+    void path_to_join(const size_t MOVABLE_ID, EST & est);
+
+    /**
+     * @brief Acknowledges an abort once the task is gone (200). Returns nullptr while its
+     * exploration did not return yet and EXPIRED is false, 202 once EXPIRED is set.
+     */
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_to_abort_pollIMPL(const int32_t REQUEST_ID, const bool EXPIRED);
+
+    /**
+     * @brief Next /path-to-stream frame of a task, never blocks: the exploration progress while
+     * it is running, Finished once the result can be taken (see path_to_result).
+     */
+    PathToStreamer::Frame path_to_frame(const int32_t REQUEST_ID);
+
+    /**
+     * @brief Last /path-to-stream frame of a finished task: takes the result and joins the
+     * exploration (blocking, runs on the worker pool).
+     */
+    std::string path_to_result(const int32_t REQUEST_ID);
+
+    /**
+     * @brief Decodes the mesh and transform of a creation request. Returns nullptr on success,
+     * the error response otherwise.
+     */
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    readUpload(const imp::server::ObjectCreationRequest::Wrapper & req_dto,
+               ObjectManager::Upload & upload);
+
+    /**
+     * @brief ObjectManager::addAsync, records the objects (RECORD_REQUESTS).
+     */
+    std::vector<size_t> addAsync(std::vector<ObjectManager::Upload> uploads);
+
+    // decoded request bodies, shared by the JSON and the binary endpoints
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    createIMPL(const bool MOVABLE, std::vector<fcl::Vector3f> & vertices,
+               std::vector<fcl::Triangle> & triangles, const Configuration & transform);
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    collides_anyIMPL(const int32_t MOVABLE_ID, const std::vector<Configuration> & transforms);
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_toIMPL(const int32_t MOVABLE_ID, const Configuration & root_configuration,
+                const std::vector<Configuration> & u_path, const int32_t PRIORITY,
+                const std::string & client, RoadmapGrower::Activity && activity);
 
     /////////
     // endpoints
     /////////
 public:
-    ENDPOINT("GET", "/", root) { return createResponse(Status::CODE_200, "imp-server running."); }
+    ENDPOINT_ASYNC("GET", "/", root)
+    {
+        ENDPOINT_ASYNC_INIT(root)
+
+        Action act() override
+        {
+            return _return(controller->createResponse(Status::CODE_200, "imp-server running."));
+        }
+    };
 
-    ENDPOINT("GET", "/clear", clear)
+    ENDPOINT_ASYNC("GET", "/clear", clear)
     {
-        OATPP_LOGI("REQUEST ", " /clear")
-        _manager.clear();
-        return createResponse(Status::CODE_200, "OK");
-    }
+        ENDPOINT_ASYNC_INIT(clear)
+        IMP_OFFLOADING(clear)
+
+        Action act() override
+        {
+            return offload("/clear", [c = controller]() {
+                OATPP_LOGI("REQUEST ", " /clear")
+#ifdef RECORD_REQUESTS
+                imp::io::RequestLog::Entry entry(imp::io::RequestLog::Type::Clear);
+#endif
+                c->_manager.clear();
+                return c->createResponse(Status::CODE_200, "OK");
+            });
+        }
+    };
+
+    /**
+     * @brief Counters, histograms and gauges in the Prometheus text format.
+     */
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response> scrape_metricsIMPL();
+    ENDPOINT_ASYNC("GET", "/metrics", scrape_metrics)
+    {
+        ENDPOINT_ASYNC_INIT(scrape_metrics)
+
+        Action act() override { return _return(controller->scrape_metricsIMPL()); }
+    };
+
+    /**
+     * @brief Buffered spans in the Chrome trace event format, only those of the given path-to
+     * request if path_to_request_id is set (its exploration and join).
+     */
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    traceIMPL(const imp::server::TraceRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/trace", trace, TraceRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     createIMPL(const imp::server::ObjectCreationRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/create", create, BODY_DTO(Object<ObjectCreationRequest>, req_dto))
-    {
-        return createIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/create", create, ObjectCreationRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    create_bulkIMPL(const imp::server::ObjectsCreationRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/create-bulk", create_bulk, ObjectsCreationRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    create_statusIMPL(const imp::server::ObjectStatusRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_ASYNC("PUT", "/create-status", create_status, ObjectStatusRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     trashesIMPL(const imp::server::ObjectsTrashRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/trashes", trashes, BODY_DTO(Object<ObjectsTrashRequest>, req_dto))
-    {
-        return trashesIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/trashes", trashes, ObjectsTrashRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     movedIMPL(const imp::server::MovedRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/moved", moved, BODY_DTO(Object<MovedRequest>, req_dto))
-    {
-        return movedIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/moved", moved, MovedRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     collidesIMPL(const imp::server::CollisionRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/collides", collides, BODY_DTO(Object<CollisionRequest>, req_dto))
-    {
-        return collidesIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/collides", collides, CollisionRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     collides_anyIMPL(const imp::server::MultipleCollisionRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/collides-any", collides_any,
-             BODY_DTO(Object<MultipleCollisionRequest>, req_dto))
-    {
-        return collides_anyIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/collides-any", collides_any, MultipleCollisionRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     new_local_closestIMPL(const imp::server::NewLocalClosestRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/new-local-closest", new_local_closest,
-             BODY_DTO(Object<NewLocalClosestRequest>, req_dto))
-    {
-        return new_local_closestIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/new-local-closest", new_local_closest, NewLocalClosestRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     is_collision_free_pathIMPL(const imp::server::NewLocalClosestRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/is-collision-free-path", is_collision_free_path,
-             BODY_DTO(Object<IsCollisionFreePathRequest>, req_dto))
-    {
-        return is_collision_free_pathIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/is-collision-free-path", is_collision_free_path,
+                          IsCollisionFreePathRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     path_toIMPL(const imp::server::PathToRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/path-to", path_to, BODY_DTO(Object<PathToRequest>, req_dto))
-    {
-        return path_toIMPL(req_dto);
-    }
+    IMP_ENDPOINT_BLOCKING("PUT", "/path-to", path_to, PathToRequest)
 
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     path_to_statusIMPL(const imp::server::PathToStatusRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/path-to-status", path_to_status,
-             BODY_DTO(Object<PathToStatusRequest>, req_dto))
+    IMP_ENDPOINT_ASYNC("PUT", "/path-to-status", path_to_status, PathToStatusRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    batchIMPL(const imp::server::BatchRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/batch", batch, BatchRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_repairIMPL(const imp::server::PathRepairRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/path-repair", path_repair, PathRepairRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    dumpwtIMPL(const imp::server::DumpRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/dumpwt", dumpwt, DumpRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    snapshot_saveIMPL(const imp::server::SnapshotRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/snapshot-save", snapshot_save, SnapshotRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    snapshot_loadIMPL(const imp::server::SnapshotRequest::Wrapper & req_dto);
+    IMP_ENDPOINT_BLOCKING("PUT", "/snapshot-load", snapshot_load, SnapshotRequest)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_to_getIMPL(const imp::server::PathToGetRequest::Wrapper & req_dto);
+    ENDPOINT_ASYNC("PUT", "/path-to-get", path_to_get)
     {
-        return path_to_statusIMPL(req_dto);
-    }
+        ENDPOINT_ASYNC_INIT(path_to_get)
+        IMP_OFFLOADING(path_to_get)
+
+        PathToGetRequest::Wrapper _req_dto;
+
+        Action act() override
+        {
+            return request
+                ->readBodyToDtoAsync<oatpp::Object<PathToGetRequest>>(
+                    controller->getDefaultObjectMapper())
+                .callbackTo(&path_to_get::onBody);
+        }
 
+        Action onBody(const oatpp::Object<PathToGetRequest> & req_dto)
+        {
+            if (!req_dto || !req_dto->path_to_request_id)
+                return _return(controller->createResponse(Status::CODE_400, "Invalid arguments!"));
+            _req_dto = req_dto;
+            return yieldTo(&path_to_get::poll);
+        }
+
+        // waits for the exploration without occupying a thread
+        Action poll()
+        {
+            bool ready{false};
+            auto response{controller->path_to_pollIMPL(_req_dto, false, ready)};
+            if (response) return _return(response);
+            if (ready)
+            {
+                return offload("/path-to-get", [c = controller, req_dto = _req_dto]() {
+                    return c->path_to_getIMPL(req_dto);
+                });
+            }
+            return waitRepeat(std::chrono::duration_cast<std::chrono::microseconds>(
+                PATH_TO_POLL_INTERVAL));
+        }
+    };
+
+    /**
+     * @brief Aborts a path-to task. Answers once the exploration acknowledged the cancellation,
+     * or with 202 after PATH_TO_ABORT_TIMEOUT.
+     */
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
     path_to_abortIMPL(const imp::server::PathToStatusRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/path-to-abort", path_to_abort, BODY_DTO(Object<PathToStatusRequest>, req_dto))
+    ENDPOINT_ASYNC("PUT", "/path-to-abort", path_to_abort)
     {
-        return path_to_abortIMPL(req_dto);
-    }
+        ENDPOINT_ASYNC_INIT(path_to_abort)
 
+        int32_t _request_id{0};
+        imp::time::Timer _timer;
+
+        Action act() override
+        {
+            return request
+                ->readBodyToDtoAsync<oatpp::Object<PathToStatusRequest>>(
+                    controller->getDefaultObjectMapper())
+                .callbackTo(&path_to_abort::onBody);
+        }
+
+        Action onBody(const oatpp::Object<PathToStatusRequest> & req_dto)
+        {
+            if (!req_dto || !req_dto->path_to_request_id)
+                return _return(controller->createResponse(Status::CODE_400, "Invalid arguments!"));
+            auto response{controller->path_to_abortIMPL(req_dto)};
+            if (response) return _return(response);
+            _request_id = req_dto->path_to_request_id;
+            _timer = imp::time::Timer();
+            return yieldTo(&path_to_abort::poll);
+        }
+
+        Action poll()
+        {
+            auto response{controller->path_to_abort_pollIMPL(
+                _request_id, _timer.elapsed() >= PATH_TO_ABORT_TIMEOUT)};
+            if (response) return _return(response);
+            return waitRepeat(std::chrono::duration_cast<std::chrono::microseconds>(
+                PATH_TO_ABORT_POLL_INTERVAL));
+        }
+    };
+
+    /**
+     * @brief Long-poll variant of /path-to-get: answers with the path as soon as the exploration
+     * finished, or with the /path-to-status result once timeout_ms passed.
+     */
+    ENDPOINT_ASYNC("PUT", "/path-to-wait", path_to_wait)
+    {
+        ENDPOINT_ASYNC_INIT(path_to_wait)
+        IMP_OFFLOADING(path_to_wait)
+
+        PathToGetRequest::Wrapper _req_dto;
+        imp::time::duration_t _timeout{0};
+        imp::time::Timer _timer;
+
+        Action act() override
+        {
+            return request
+                ->readBodyToDtoAsync<oatpp::Object<PathToWaitRequest>>(
+                    controller->getDefaultObjectMapper())
+                .callbackTo(&path_to_wait::onBody);
+        }
+
+        Action onBody(const oatpp::Object<PathToWaitRequest> & req_dto)
+        {
+            OATPP_LOGV("REQUEST ", " /path-to-wait")
+            if (!req_dto || !req_dto->path_to_request_id)
+                return _return(controller->createResponse(Status::CODE_400, "Invalid arguments!"));
+            _req_dto = PathToGetRequest::createShared();
+            _req_dto->path_to_request_id = req_dto->path_to_request_id;
+            _req_dto->movable_id = req_dto->movable_id;
+            _timeout = std::clamp<imp::time::duration_t>(
+                std::chrono::milliseconds(req_dto->timeout_ms ? *req_dto->timeout_ms : 0), 0ms,
+                PATH_TO_WAIT_MAX_TIMEOUT);
+            _timer = imp::time::Timer();
+            return yieldTo(&path_to_wait::poll);
+        }
+
+        Action poll()
+        {
+            bool ready{false};
+            auto response{
+                controller->path_to_pollIMPL(_req_dto, _timer.elapsed() >= _timeout, ready)};
+            if (response) return _return(response);
+            if (ready)
+            {
+                return offload("/path-to-wait", [c = controller, req_dto = _req_dto]() {
+                    return c->path_to_getIMPL(req_dto);
+                });
+            }
+            return waitRepeat(std::chrono::duration_cast<std::chrono::microseconds>(
+                PATH_TO_POLL_INTERVAL));
+        }
+    };
+
+    /**
+     * @brief WebSocket channel of a path-to task. The server pushes text frames
+     * {"type": "progress", ...} while exploring and {"type": "path", ...} once the task
+     * finished (the result is taken, like /path-to-get), then closes the connection.
+     */
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
-    path_to_getIMPL(const imp::server::PathToGetRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/path-to-get", path_to_get, BODY_DTO(Object<PathToGetRequest>, req_dto))
+    path_to_streamIMPL(const std::shared_ptr<IncomingRequest> & request);
+    ENDPOINT_ASYNC("GET", "/path-to-stream/{path_to_request_id}", path_to_stream)
     {
-        return path_to_getIMPL(req_dto);
-    }
+        ENDPOINT_ASYNC_INIT(path_to_stream)
+
+        Action act() override { return _return(controller->path_to_streamIMPL(request)); }
+    };
 
+    /////////
+    // binary endpoints (application/octet-stream, see BinaryCodec)
+    /////////
+public:
     std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
-    dumpwtIMPL(const imp::server::DumpRequest::Wrapper & req_dto);
-    ENDPOINT("PUT", "/dumpwt", dumpwt, BODY_DTO(Object<DumpRequest>, req_dto))
+    create_binIMPL(const oatpp::String & body);
+    IMP_ENDPOINT_BLOCKING_BINARY("PUT", "/create-bin", create_bin)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    collides_any_binIMPL(const oatpp::String & body);
+    IMP_ENDPOINT_BLOCKING_BINARY("PUT", "/collides-any-bin", collides_any_bin)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_to_binIMPL(const oatpp::String & body);
+    IMP_ENDPOINT_BLOCKING_BINARY("PUT", "/path-to-bin", path_to_bin)
+
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::Response>
+    path_to_get_binIMPL(const imp::server::PathToGetRequest::Wrapper & req_dto);
+    ENDPOINT_ASYNC("PUT", "/path-to-get-bin", path_to_get_bin)
     {
-        return dumpwtIMPL(req_dto);
-    }
+        ENDPOINT_ASYNC_INIT(path_to_get_bin)
+        IMP_OFFLOADING(path_to_get_bin)
+
+        PathToGetRequest::Wrapper _req_dto;
+
+        Action act() override
+        {
+            return request
+                ->readBodyToDtoAsync<oatpp::Object<PathToGetRequest>>(
+                    controller->getDefaultObjectMapper())
+                .callbackTo(&path_to_get_bin::onBody);
+        }
+
+        Action onBody(const oatpp::Object<PathToGetRequest> & req_dto)
+        {
+            if (!req_dto || !req_dto->path_to_request_id)
+                return _return(controller->createResponse(Status::CODE_400, "Invalid arguments!"));
+            _req_dto = req_dto;
+            return yieldTo(&path_to_get_bin::poll);
+        }
+
+        Action poll()
+        {
+            bool ready{false};
+            auto response{controller->path_to_pollIMPL(_req_dto, false, ready)};
+            if (response) return _return(response);
+            if (ready)
+            {
+                return offload("/path-to-get-bin", [c = controller, req_dto = _req_dto]() {
+                    return c->path_to_get_binIMPL(req_dto);
+                });
+            }
+            return waitRepeat(std::chrono::duration_cast<std::chrono::microseconds>(
+                PATH_TO_POLL_INTERVAL));
+        }
+    };
 };
 
 #include OATPP_CODEGEN_END(ApiController) ///< End Codegen
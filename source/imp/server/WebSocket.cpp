@@ -0,0 +1,156 @@
+#include "imp/server/WebSocket.hpp"
+
+#include <array>
+
+namespace
+{
+
+constexpr const char * HANDSHAKE_GUID{"258EAFA5-E914-47DA-95CA-C5AB0DC85B11"};
+
+inline uint32_t rotl(const uint32_t value, const int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+std::array<uint8_t, 20> sha1(const std::string & message)
+{
+    uint32_t h[5]{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    // padding: 0x80, zeros and the message length in bits (big-endian)
+    std::string data{message};
+    const uint64_t BITS{static_cast<uint64_t>(message.size()) * 8};
+    data.push_back(static_cast<char>(0x80));
+    while (data.size() % 64 != 56) data.push_back(0);
+    for (int i = 7; i >= 0; --i) data.push_back(static_cast<char>((BITS >> (8 * i)) & 0xFF));
+
+    for (size_t chunk = 0; chunk < data.size(); chunk += 64)
+    {
+        uint32_t w[80];
+        for (size_t i = 0; i < 16; ++i)
+        {
+            w[i] = 0;
+            for (size_t k = 0; k < 4; ++k)
+                w[i] = (w[i] << 8) | static_cast<uint8_t>(data[chunk + 4 * i + k]);
+        }
+        for (size_t i = 16; i < 80; ++i)
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a{h[0]}, b{h[1]}, c{h[2]}, d{h[3]}, e{h[4]};
+        for (size_t i = 0; i < 80; ++i)
+        {
+            uint32_t f, k;
+            if (i < 20)
+                f = (b & c) | (~b & d), k = 0x5A827999;
+            else if (i < 40)
+                f = b ^ c ^ d, k = 0x6ED9EBA1;
+            else if (i < 60)
+                f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+            else
+                f = b ^ c ^ d, k = 0xCA62C1D6;
+
+            const uint32_t TEMP{rotl(a, 5) + f + e + k + w[i]};
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = TEMP;
+        }
+
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest;
+    for (size_t i = 0; i < 20; ++i)
+        digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - 8 * (i % 4)));
+    return digest;
+}
+
+std::string base64(const uint8_t * data, const size_t SIZE)
+{
+    constexpr const char * ALPHABET{
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+    std::string result;
+    for (size_t i = 0; i < SIZE; i += 3)
+    {
+        uint32_t block{static_cast<uint32_t>(data[i]) << 16};
+        if (i + 1 < SIZE) block |= static_cast<uint32_t>(data[i + 1]) << 8;
+        if (i + 2 < SIZE) block |= static_cast<uint32_t>(data[i + 2]);
+
+        result.push_back(ALPHABET[(block >> 18) & 0x3F]);
+        result.push_back(ALPHABET[(block >> 12) & 0x3F]);
+        result.push_back(i + 1 < SIZE ? ALPHABET[(block >> 6) & 0x3F] : '=');
+        result.push_back(i + 2 < SIZE ? ALPHABET[block & 0x3F] : '=');
+    }
+    return result;
+}
+
+} // namespace
+
+std::string imp::server::WebSocket::acceptKey(const std::string & key)
+{
+    const auto DIGEST{sha1(key + HANDSHAKE_GUID)};
+    return base64(DIGEST.data(), DIGEST.size());
+}
+
+std::string imp::server::WebSocket::frame(const uint8_t OPCODE, const std::string & payload)
+{
+    std::string result;
+    result.push_back(static_cast<char>(0x80 | OPCODE)); // FIN
+
+    const uint64_t SIZE{payload.size()};
+    if (SIZE < 126)
+    {
+        result.push_back(static_cast<char>(SIZE));
+    }
+    else if (SIZE <= 0xFFFF)
+    {
+        result.push_back(static_cast<char>(126));
+        for (int i = 1; i >= 0; --i) result.push_back(static_cast<char>((SIZE >> (8 * i)) & 0xFF));
+    }
+    else
+    {
+        result.push_back(static_cast<char>(127));
+        for (int i = 7; i >= 0; --i) result.push_back(static_cast<char>((SIZE >> (8 * i)) & 0xFF));
+    }
+
+    result += payload;
+    return result;
+}
+
+std::optional<imp::server::WebSocket::Message> imp::server::WebSocket::read(std::string & buffer)
+{
+    if (buffer.size() < 2) return std::nullopt;
+    const auto * data{reinterpret_cast<const uint8_t *>(buffer.data())};
+
+    uint64_t size{data[1] & 0x7Fu};
+    size_t offset{2};
+    if (size == 126 || size == 127)
+    {
+        const size_t BYTES{size == 126 ? 2u : 8u};
+        if (buffer.size() < offset + BYTES) return std::nullopt;
+        size = 0;
+        for (size_t i = 0; i < BYTES; ++i) size = (size << 8) | data[offset + i];
+        offset += BYTES;
+    }
+
+    // client frames are masked (RFC 6455 5.3)
+    const bool MASKED{(data[1] & 0x80u) != 0};
+    const size_t MASK{offset};
+    if (MASKED) offset += 4;
+    if (buffer.size() < offset || buffer.size() - offset < size) return std::nullopt;
+
+    Message message{static_cast<uint8_t>(data[0] & 0x0Fu), buffer.substr(offset, size)};
+    if (MASKED)
+    {
+        for (size_t i = 0; i < message.Payload.size(); ++i)
+            message.Payload[i] = static_cast<char>(message.Payload[i] ^ data[MASK + i % 4]);
+    }
+
+    buffer.erase(0, offset + size);
+    return message;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace imp::server
+{
+
+/**
+ * @brief Minimal server side of RFC 6455 for push-only channels: the handshake key, the
+ * encoding of unmasked, unfragmented frames and the decoding of client frames (to answer
+ * control frames, fragments are returned as they are).
+ */
+class WebSocket
+{
+    /////////
+    // data
+    /////////
+public:
+    static constexpr uint8_t OPCODE_TEXT{0x1};
+    static constexpr uint8_t OPCODE_CLOSE{0x8};
+    static constexpr uint8_t OPCODE_PING{0x9};
+    static constexpr uint8_t OPCODE_PONG{0xA};
+
+    struct Message
+    {
+        uint8_t Opcode{0};
+        std::string Payload; // unmasked
+    };
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Sec-WebSocket-Accept value for the Sec-WebSocket-Key of a handshake request.
+     */
+    static std::string acceptKey(const std::string & key);
+
+    /**
+     * @brief Encodes payload as a single final frame with the given opcode.
+     */
+    static std::string frame(const uint8_t OPCODE, const std::string & payload);
+
+    /**
+     * @brief Decodes the frame at the front of buffer and removes it, std::nullopt if it is not
+     * complete yet.
+     */
+    static std::optional<Message> read(std::string & buffer);
+};
+
+} // namespace imp::server
@@ -0,0 +1,34 @@
+#include "imp/server/WorkerPool.hpp"
+
+imp::server::WorkerPool::WorkerPool(const size_t THREADS)
+{
+    for (size_t i = 0; i < THREADS; ++i) _workers.emplace_back(&WorkerPool::run, this);
+}
+
+imp::server::WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _running = false;
+    }
+    _condition.notify_all();
+    for (auto & worker : _workers) worker.join();
+}
+
+void imp::server::WorkerPool::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _condition.wait(lock, [this]() { return !_running || !_jobs.empty(); });
+        if (_jobs.empty()) break; // stopped, queued jobs are still answered
+
+        auto job{std::move(_jobs.front())};
+        _jobs.pop_front();
+
+        lock.unlock();
+        job();
+        job = nullptr; // releases the captured state outside of the lock
+        lock.lock();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace imp::server
+{
+
+/**
+ * @brief Fixed set of threads for the blocking request handlers, keeps them off the coroutine
+ * processors. Jobs run in submission order, the result is delivered through a future which the
+ * endpoint coroutine polls.
+ */
+class WorkerPool
+{
+    /////////
+    // data
+    /////////
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::function<void()>> _jobs;
+    bool _running{true};
+
+    std::vector<std::thread> _workers;
+
+    /////////
+    // constructors
+    /////////
+public:
+    explicit WorkerPool(const size_t THREADS);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool & operator=(const WorkerPool &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    template <typename Work>
+    std::future<std::invoke_result_t<Work>> submit(Work work)
+    {
+        using Result = std::invoke_result_t<Work>;
+
+        // std::function needs a copyable job, the task is shared
+        auto task{std::make_shared<std::packaged_task<Result()>>(std::move(work))};
+        auto future{task->get_future()};
+        {
+            std::lock_guard<std::mutex> guard(_mutex);
+            _jobs.emplace_back([task]() { (*task)(); });
+        }
+        _condition.notify_one();
+        return future;
+    }
+
+private:
+    void run();
+};
+
+} // namespace imp::server
@@ -7,11 +7,12 @@ namespace imp::time
 
 using namespace std::literals::chrono_literals;
 
-using duration_t =
-    std::chrono::duration<std::chrono::system_clock::rep, std::chrono::system_clock::period>;
+// monotonic, unaffected by changes of the system time
+using duration_t = std::chrono::steady_clock::duration;
 
 /**
  * @brief Simple timer class that starts automatically on construction with an elapsed method.
+ * Measures on the steady clock.
  * 
  * @author Ronja Schnur (rschnur@students.uni-mainz.de)
  */
@@ -21,19 +22,19 @@ class Timer
     // data
     /////////
 private:
-    std::chrono::system_clock::time_point _startup;
+    std::chrono::steady_clock::time_point _startup;
 
     /////////
     // constructors
     /////////
 public:
-    Timer() : _startup{std::chrono::system_clock::now()} {}
+    Timer() : _startup{std::chrono::steady_clock::now()} {}
 
 public:
     /**
      * @brief Get the elapsed duration since construction.
      */
-    duration_t elapsed() { return std::chrono::system_clock::now() - _startup; }
+    duration_t elapsed() const { return std::chrono::steady_clock::now() - _startup; }
 };
 
 } // namespace imp::time
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "imp/time/Tracer.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <queue>
+
+imp::time::Tracer & imp::time::Tracer::get()
+{
+    static Tracer instance;
+    return instance;
+}
+
+imp::time::TraceBuffer * imp::time::Tracer::attach()
+{
+    auto buffer{std::make_unique<TraceBuffer>()};
+    buffer->Events.resize(TRACE_BUFFER_SIZE);
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    buffer->Thread = _thread_counter++;
+    return _buffers.emplace_back(std::move(buffer)).get();
+}
+
+void imp::time::Tracer::detach(TraceBuffer * buffer)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _buffers.remove_if([buffer](const auto & b) { return b.get() == buffer; });
+}
+
+bool imp::time::Tracer::write(std::ostream & os, const int64_t REQUEST)
+{
+    using Entry = std::pair<uint32_t, TraceEvent>; // thread, event
+    auto later = [](const Entry & a, const Entry & b) { return a.second.Begin > b.second.Begin; };
+
+    // the latest TRACE_EXPORT_MAX_SPANS spans, the earliest on top
+    std::priority_queue<Entry, std::vector<Entry>, decltype(later)> latest(later);
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        for (const auto & buffer : _buffers)
+        {
+            std::lock_guard<std::mutex> buffer_guard(buffer->Mutex);
+            const size_t FIRST{buffer->Written > TRACE_BUFFER_SIZE
+                                   ? buffer->Written - TRACE_BUFFER_SIZE
+                                   : 0};
+            for (size_t i = FIRST; i < buffer->Written; ++i)
+            {
+                const auto & event{buffer->Events[i % TRACE_BUFFER_SIZE]};
+                if (REQUEST != NO_REQUEST && event.Request != REQUEST) continue;
+                latest.emplace(buffer->Thread, event);
+                if (latest.size() > TRACE_EXPORT_MAX_SPANS) latest.pop();
+            }
+        }
+    }
+    if (REQUEST != NO_REQUEST && latest.empty()) return false;
+
+    std::vector<Entry> events;
+    events.reserve(latest.size());
+    for (; !latest.empty(); latest.pop()) events.emplace_back(latest.top());
+
+    // complete events ("X"), timestamps in microseconds
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    os << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto & [thread, event] = events[i];
+        os << (i ? "," : "") << "\n{\"name\":\"" << event.Name
+           << "\",\"cat\":\"imp\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+           << ",\"ts\":" << event.Begin * 1e-3 << ",\"dur\":" << (event.End - event.Begin) * 1e-3;
+        if (event.Request != NO_REQUEST) os << ",\"args\":{\"request\":" << event.Request << "}";
+        os << "}";
+    }
+    os << "\n]}\n";
+    return true;
+}
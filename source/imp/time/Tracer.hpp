@@ -0,0 +1,207 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "imp/Settings.hpp"
+
+namespace imp::time
+{
+
+/**
+ * @brief A finished span, times in nanoseconds since the tracer was created.
+ */
+struct TraceEvent
+{
+    const char * Name{nullptr}; // static string
+    uint64_t Begin{0};
+    uint64_t End{0};
+    int64_t Request{-1}; // see TraceScope
+};
+
+/**
+ * @brief Ring buffer of a single thread, keeps the last TRACE_BUFFER_SIZE spans. Only the owning
+ * thread appends, the mutex is contended by exports only.
+ */
+struct TraceBuffer
+{
+    std::mutex Mutex;
+    std::vector<TraceEvent> Events;
+    size_t Written{0}; // total appended, Written % TRACE_BUFFER_SIZE is the next slot
+    uint32_t Thread{0};
+};
+
+/**
+ * @brief Process wide span tracer (Tracer::get()). Spans (see Span) are recorded on the steady
+ * clock into per thread ring buffers and exported in the Chrome trace event format (load in
+ * chrome://tracing or ui.perfetto.dev). Spans of finished threads are dropped.
+ *
+ * TRACE_LEVEL selects the detail: 1 records the HTTP handlers and the phases of the planning
+ * pipeline, 2 additionally every ObjectManager query (quickly overwrites the ring buffers
+ * during explorations).
+ */
+class Tracer
+{
+    /////////
+    // data
+    /////////
+public:
+    static constexpr int64_t NO_REQUEST{-1};
+
+private:
+    const std::chrono::steady_clock::time_point _ORIGIN{std::chrono::steady_clock::now()};
+
+    std::mutex _mutex;
+    std::list<std::unique_ptr<TraceBuffer>> _buffers;
+    uint32_t _thread_counter{0};
+
+    /////////
+    // methods
+    /////////
+public:
+    static Tracer & get();
+
+    TraceBuffer * attach();
+
+    void detach(TraceBuffer * buffer);
+
+    inline uint64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - _ORIGIN)
+            .count();
+    }
+
+    /**
+     * @brief Writes the buffered spans as Chrome trace event JSON, at most the latest
+     * TRACE_EXPORT_MAX_SPANS. For a request (see TraceScope) only its spans are written.
+     *
+     * @return false if no span of the request is buffered (nothing is written).
+     */
+    bool write(std::ostream & os, const int64_t REQUEST = NO_REQUEST);
+};
+
+namespace _implementation
+{
+
+struct Attachment
+{
+    TraceBuffer * Buffer;
+
+    Attachment() : Buffer{Tracer::get().attach()} {}
+    ~Attachment() { Tracer::get().detach(Buffer); }
+};
+
+inline TraceBuffer & local()
+{
+    thread_local Attachment attachment;
+    return *attachment.Buffer;
+}
+
+inline int64_t & request()
+{
+    thread_local int64_t current{Tracer::NO_REQUEST};
+    return current;
+}
+
+inline void record(const TraceEvent & event)
+{
+    auto & buffer{local()};
+    std::lock_guard<std::mutex> guard(buffer.Mutex);
+    buffer.Events[buffer.Written++ % TRACE_BUFFER_SIZE] = event;
+}
+
+} // namespace _implementation
+
+/**
+ * @brief The request spans of the current thread are attributed to.
+ */
+inline int64_t request() { return _implementation::request(); }
+
+/**
+ * @brief Attributes the spans of the current thread ending from now on to the given request
+ * (e.g. once its id is known), up to the end of the enclosing TraceScope.
+ */
+inline void attribute(const int64_t REQUEST) { _implementation::request() = REQUEST; }
+
+/**
+ * @brief Attributes the spans of the current thread to the given request during its lifetime.
+ * Parallel regions have to pass request() on to their workers.
+ */
+class TraceScope
+{
+    /////////
+    // data
+    /////////
+private:
+    const int64_t _PREVIOUS;
+
+    /////////
+    // constructors
+    /////////
+public:
+    explicit TraceScope(const int64_t REQUEST) : _PREVIOUS{_implementation::request()}
+    {
+        _implementation::request() = REQUEST;
+    }
+    ~TraceScope() { _implementation::request() = _PREVIOUS; }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope & operator=(const TraceScope &) = delete;
+};
+
+/**
+ * @brief Records its lifetime as a span if LEVEL <= TRACE_LEVEL. The name has to be a static
+ * string.
+ */
+class Span
+{
+    /////////
+    // data
+    /////////
+private:
+    const char * _name;
+    uint64_t _begin;
+
+    /////////
+    // constructors
+    /////////
+public:
+    explicit Span(const char * NAME, const size_t LEVEL = 1)
+        : _name{LEVEL <= TRACE_LEVEL ? NAME : nullptr}, _begin{_name ? Tracer::get().now() : 0}
+    {}
+    ~Span() { end(); }
+
+    Span(const Span &) = delete;
+    Span & operator=(const Span &) = delete;
+
+    /////////
+    // methods
+    /////////
+public:
+    /**
+     * @brief Ends this span and starts the next one (for consecutive phases).
+     */
+    inline void next(const char * NAME)
+    {
+        if (!_name) return;
+        end();
+        _name = NAME;
+        _begin = Tracer::get().now();
+    }
+
+private:
+    inline void end()
+    {
+        if (!_name) return;
+        _implementation::record({_name, _begin, Tracer::get().now(), request()});
+        _name = nullptr;
+    }
+};
+
+} // namespace imp::time
@@ -0,0 +1,385 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "imp/CKDTree.hpp"
+#include "imp/Configuration.hpp"
+#include "imp/EST.hpp"
+#include "imp/ObjectManager.hpp"
+#include "imp/io/ESTDumper.hpp"
+#include "imp/random/Sampler.hpp"
+
+/**
+ * imp-bench: micro-benchmarks of the planner kernels (collision queries, path validation,
+ * CKDTree, Sampler, distances and full explorations) on generated scenes. All inputs derive
+ * from a fixed seed and explorations run in the deterministic mode, so runs of different builds
+ * do the same work. Results are written as JSON (stdout or --out) for tracking over time,
+ * progress goes to stderr.
+ *
+ * usage: imp-bench [--filter <substring>] [--min-time <ms>] [--seed <seed>] [--out <file>]
+ */
+
+namespace
+{
+
+constexpr size_t INPUTS{4096};                      // precomputed inputs per benchmark
+constexpr size_t SCENE_SIZES[]{16, 128};            // static objects
+constexpr size_t TREE_SIZES[]{1024, 16384, 131072}; // CKDTree points
+constexpr float SCENE_RADIUS{0.4f};                 // statics are placed within
+constexpr float STATIC_MIN_EXTENT{0.02f}, STATIC_MAX_EXTENT{0.06f};
+constexpr float MOVABLE_EXTENT{0.02f};
+const imp::Configuration ROOT{fcl::Vector3f{-0.6f, 0.0f, 0.0f}}; // outside of the statics
+const imp::Configuration GOAL{fcl::Vector3f{0.6f, 0.0f, 0.0f}};
+
+struct Result
+{
+    std::string Name;
+    size_t Parameter{0};
+    size_t Operations{0};
+    double Seconds{0.0};
+    std::map<std::string, double> Counters;
+};
+
+/**
+ * @brief Axis aligned box mesh with the given half extent, centered at the origin.
+ */
+void box(const float EXTENT, std::vector<fcl::Vector3f> & vertices,
+         std::vector<fcl::Triangle> & triangles)
+{
+    vertices.clear();
+    for (size_t i = 0; i < 8; ++i)
+        vertices.emplace_back(i & 1 ? EXTENT : -EXTENT, //
+                              i & 2 ? EXTENT : -EXTENT, //
+                              i & 4 ? EXTENT : -EXTENT);
+
+    triangles = {{0, 2, 1}, {1, 2, 3}, {4, 5, 6}, {5, 7, 6}, {0, 1, 4}, {1, 5, 4},
+                 {2, 6, 3}, {3, 6, 7}, {0, 4, 2}, {2, 4, 6}, {1, 3, 5}, {3, 7, 5}};
+}
+
+/**
+ * @brief Randomly placed and rotated static boxes around the origin and a movable box. ROOT and
+ * GOAL are collision free.
+ */
+struct Scene
+{
+    imp::ObjectManager Manager;
+    size_t Movable{0};
+
+    Scene(const size_t STATICS, const uint64_t SEED)
+    {
+        auto sampler{imp::random::Sampler(SEED, STATICS)};
+        std::vector<fcl::Vector3f> vertices;
+        std::vector<fcl::Triangle> triangles;
+
+        for (size_t i = 0; i < STATICS; ++i)
+        {
+            box(STATIC_MIN_EXTENT + sampler.rand() * (STATIC_MAX_EXTENT - STATIC_MIN_EXTENT),
+                vertices, triangles);
+            Manager.add(false, vertices, triangles,
+                        imp::Configuration{sampler.randUniformPointInUnitSphere() * SCENE_RADIUS,
+                                           sampler.randUniformUnitQuaternion()});
+        }
+
+        box(MOVABLE_EXTENT, vertices, triangles);
+        Movable = Manager.add(true, vertices, triangles, imp::Configuration());
+    }
+};
+
+class Bench
+{
+    /////////
+    // data
+    /////////
+private:
+    const std::string _FILTER;
+    const imp::time::duration_t _MIN_TIME;
+    const uint64_t _SEED;
+    std::vector<Result> _results;
+    volatile double _sink{0.0}; // keeps the benchmarked results alive
+
+    /////////
+    // constructors
+    /////////
+public:
+    Bench(const std::string & filter, const imp::time::duration_t & min_time, uint64_t seed)
+        : _FILTER{filter}, _MIN_TIME{min_time}, _SEED{seed}
+    {}
+
+    /////////
+    // methods
+    /////////
+public:
+    void run()
+    {
+        distances();
+        sampler();
+        for (const size_t SIZE : TREE_SIZES) ckdtree(SIZE);
+        for (const size_t STATICS : SCENE_SIZES) scene(STATICS);
+    }
+
+    void write(std::ostream & os) const
+    {
+        os << "{\n  \"timestamp\": "
+           << std::chrono::duration_cast<std::chrono::seconds>(
+                  std::chrono::system_clock::now().time_since_epoch())
+                  .count()
+           << ",\n  \"threads\": " << MAX_OMP_THREADS << ",\n  \"seed\": " << _SEED
+           << ",\n  \"benchmarks\": [";
+
+        os << std::setprecision(9);
+        for (size_t i = 0; i < _results.size(); ++i)
+        {
+            const auto & result{_results[i]};
+            os << (i ? ",\n" : "\n") << "    {\"name\": \"" << result.Name
+               << "\", \"parameter\": " << result.Parameter
+               << ", \"operations\": " << result.Operations
+               << ", \"seconds\": " << result.Seconds
+               << ", \"ns_per_op\": " << result.Seconds * 1e9 / result.Operations
+               << ", \"ops_per_second\": " << result.Operations / result.Seconds;
+            if (!result.Counters.empty())
+            {
+                os << ", \"counters\": {";
+                for (auto it = result.Counters.begin(); it != result.Counters.end(); ++it)
+                    os << (it == result.Counters.begin() ? "" : ", ") << "\"" << it->first
+                       << "\": " << it->second;
+                os << "}";
+            }
+            os << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+private:
+    bool enabled(const std::string & name) const
+    {
+        return name.find(_FILTER) != std::string::npos;
+    }
+
+    /**
+     * @brief Calls fn(i) (ITEMS operations each) in rounds of doubling size until a round takes
+     * at least the minimum time, the last round is reported. nullptr if filtered out.
+     */
+    template <class fn_t>
+    Result * measure(const std::string & name, const size_t PARAMETER, const size_t ITEMS,
+                     const fn_t & fn)
+    {
+        if (!enabled(name)) return nullptr;
+        std::cerr << name << "/" << PARAMETER << std::flush;
+
+        Result result{name, PARAMETER};
+        for (size_t iterations = 1;; iterations *= 2)
+        {
+            imp::time::Timer timer;
+            for (size_t i = 0; i < iterations; ++i) _sink = fn(i);
+            const imp::time::duration_t ELAPSED{timer.elapsed()};
+
+            if (ELAPSED >= _MIN_TIME)
+            {
+                result.Operations = iterations * ITEMS;
+                result.Seconds = std::chrono::duration<double>(ELAPSED).count();
+                break;
+            }
+        }
+
+        std::cerr << "  " << result.Seconds * 1e9 / result.Operations << " ns/op" << std::endl;
+        _results.emplace_back(std::move(result));
+        return &_results.back();
+    }
+
+    std::vector<imp::Configuration> configurations(const size_t COUNT, const uint64_t STREAM,
+                                                   const float RADIUS = 1.0f) const
+    {
+        auto sampler{imp::random::Sampler(_SEED, STREAM)};
+        std::vector<imp::Configuration> result;
+        result.reserve(COUNT);
+        for (size_t i = 0; i < COUNT; ++i)
+            result.emplace_back(sampler.randUniformPointInUnitSphere() * RADIUS,
+                                sampler.randUniformUnitQuaternion());
+        return result;
+    }
+
+    void distances()
+    {
+        const auto A{configurations(INPUTS, 1)}, B{configurations(INPUTS, 2)};
+
+        measure("distance", 0, 1, [&](const size_t I) {
+            return imp::Distance(A[I % INPUTS], B[I % INPUTS]);
+        });
+        measure("pair-distance", 0, 1, [&](const size_t I) {
+            return imp::PairDistance(A[I % INPUTS], B[I % INPUTS]).first;
+        });
+    }
+
+    void sampler()
+    {
+        auto sampler{imp::random::Sampler(_SEED, 3)};
+        const imp::Configuration BASE;
+
+        measure("sampler-unit-sphere", 0, 1,
+                [&](const size_t) { return sampler.randUniformPointInUnitSphere().x(); });
+        measure("sampler-unit-quaternion", 0, 1,
+                [&](const size_t) { return sampler.randUniformUnitQuaternion().w(); });
+        measure("sampler-limit-rotation", 0, 1, [&](const size_t) {
+            return sampler.randLimitUnitRotation(EST_SAMPLE_MAX_ROTATIONAL_DISTANCE).w();
+        });
+        measure("sampler-configuration", 0, 1, [&](const size_t) {
+            return sampler
+                .randConfigurationArround(BASE, EST_SAMPLE_MAX_POSITIONAL_DISTANCE,
+                                          EST_SAMPLE_MAX_ROTATIONAL_DISTANCE)
+                .Position.x();
+        });
+    }
+
+    void ckdtree(const size_t SIZE)
+    {
+        const imp::CKDTreeBox TREE_DOMAIN(fcl::Vector3f{-1.0f, -1.0f, -1.0f},
+                                     fcl::Quaternionf{-1.0f, -1.0f, -1.0f, -1.0f},
+                                     fcl::Vector3f{1.0f, 1.0f, 1.0f},
+                                     fcl::Quaternionf{1.0f, 1.0f, 1.0f, 1.0f});
+        const imp::DistancePair CLUSTER{EST_POSITIONAL_CLUSTER_DISTANCE,
+                                        EST_ROTATIONAL_CLUSTER_DISTANCE};
+
+        std::vector<imp::CKDData> points;
+        for (const auto & c : configurations(SIZE, 4)) points.emplace_back(c);
+
+        // incremental insertion (rates every point by its neighbours, as the EST does)
+        measure("ckdtree-insert", SIZE, SIZE, [&](const size_t) {
+            std::vector<imp::CKDData> data{points};
+            imp::CKDTree<imp::CKDData> tree(data, TREE_DOMAIN, CLUSTER);
+            return double(data.back().Rating);
+        });
+
+        measure("ckdtree-insert-bulk", SIZE, SIZE, [&](const size_t) {
+            std::vector<imp::CKDData> data{points};
+            imp::CKDTree<imp::CKDData> tree(data, TREE_DOMAIN, CLUSTER, 1024, false);
+            tree.insertBulk();
+            return double(tree.memoryUsage());
+        });
+
+        std::vector<imp::CKDData> data{points};
+        imp::CKDTree<imp::CKDData> tree(data, TREE_DOMAIN, CLUSTER);
+        const auto QUERIES{configurations(INPUTS, 5)};
+        size_t found{0}, queries{0};
+        if (auto result = measure("ckdtree-within", SIZE, 1, [&](const size_t I) {
+                queries++;
+                found += tree.within(QUERIES[I % INPUTS], CLUSTER).size();
+                return double(found);
+            }))
+            result->Counters["mean_results"] = double(found) / queries;
+    }
+
+    void scene(const size_t STATICS)
+    {
+        if (!enabled("collides") && !enabled("collision-free-path") && !enabled("explore"))
+            return;
+
+        Scene scene(STATICS, _SEED);
+        auto & manager{scene.Manager};
+        const size_t ID{scene.Movable};
+
+        const auto POSES{configurations(INPUTS, 6, SCENE_RADIUS + STATIC_MAX_EXTENT)};
+        size_t collisions{0}, queries{0};
+        if (auto result = measure("collides", STATICS, 1, [&](const size_t I) {
+                queries++;
+                collisions += manager.collides(ID, POSES[I % INPUTS]);
+                return double(collisions);
+            }))
+            result->Counters["collision_rate"] = double(collisions) / queries;
+
+        // short edges as validated by the EST
+        auto sampler{imp::random::Sampler(_SEED, 7)};
+        std::vector<imp::Configuration> ends;
+        for (const auto & start : POSES)
+            ends.emplace_back(sampler.randConfigurationArround(
+                start, EST_SAMPLE_MAX_POSITIONAL_DISTANCE, EST_SAMPLE_MAX_ROTATIONAL_DISTANCE));
+        size_t collision_free{0}, edges{0};
+        if (auto result = measure("collision-free-path", STATICS, 1, [&](const size_t I) {
+                edges++;
+                collision_free +=
+                    manager.isCollisionFreePath(ID, POSES[I % INPUTS], ends[I % INPUTS]);
+                return double(collision_free);
+            }))
+            result->Counters["free_rate"] = double(collision_free) / edges;
+
+        // full explorations from ROOT to GOAL through the statics, the expansion batch adapts
+        // to the acceptance rate (see ESTStatistics)
+        const std::vector<std::pair<size_t, imp::Configuration>> MATCHEES{{0, GOAL}};
+        auto est{manager.est(ID)};
+        est->seed(_SEED);
+        size_t matched{0}, runs{0}, nodes{0}, candidates{0}, iterations{0};
+        double seconds{0.0};
+        if (auto result = measure("explore", STATICS, 1, [&](const size_t) {
+                runs++;
+                matched += est->explore(ROOT, MATCHEES).first >= 0;
+                const auto & statistics{est->statistics()};
+                nodes += statistics.Accepted;
+                candidates += statistics.Candidates;
+                iterations += statistics.Iterations;
+                seconds += statistics.Seconds;
+                return double(matched);
+            }))
+        {
+            result->Counters["match_rate"] = double(matched) / runs;
+            result->Counters["nodes_per_second"] = seconds > 0.0 ? nodes / seconds : 0.0;
+            result->Counters["acceptance_rate"] = candidates ? double(nodes) / candidates : 0.0;
+            result->Counters["batch_size"] = iterations ? double(candidates) / iterations : 0.0;
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    std::string filter, out;
+    imp::time::duration_t min_time{std::chrono::milliseconds(500)};
+    uint64_t seed{EST_DETERMINISTIC_SEED};
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string OPTION{argv[i]};
+        if (OPTION == "--filter")
+            filter = argv[i + 1];
+        else if (OPTION == "--min-time")
+            min_time = std::chrono::duration_cast<imp::time::duration_t>(
+                std::chrono::milliseconds(std::stoull(argv[i + 1])));
+        else if (OPTION == "--seed")
+            seed = std::stoull(argv[i + 1]);
+        else if (OPTION == "--out")
+            out = argv[i + 1];
+        else
+        {
+            std::cerr << "usage: imp-bench [--filter <substring>] [--min-time <ms>] "
+                         "[--seed <seed>] [--out <file>]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    omp_set_num_threads(MAX_OMP_THREADS);
+
+    // dump I/O would be measured as part of the explorations
+    imp::io::ESTDumper::get().setEnabled(false);
+
+    Bench bench(filter, min_time, seed);
+    bench.run();
+
+    if (out.empty())
+    {
+        bench.write(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::ofstream file(out);
+    bench.write(file);
+    return file ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "imp/EST.hpp"
+#include "imp/ObjectManager.hpp"
+#include "imp/WorldTree.hpp"
+#include "imp/io/RequestLog.hpp"
+#include "imp/server/BinaryCodec.hpp"
+
+/**
+ * imp-replay: re-issues a request log (RECORD_REQUESTS) directly against ObjectManager, EST and
+ * WorldTree and reports latency percentiles per request type. Records are replayed in the order
+ * the requests started. Path-to requests run the same pipeline as /path-to followed by
+ * /path-to-get (roadmap query, else exploration and join).
+ *
+ * usage: imp-replay <log> [--seed <seed>]
+ */
+
+using imp::io::RequestLog;
+using imp::server::BinaryCodec;
+
+namespace
+{
+
+struct Latencies
+{
+    std::vector<double> Replayed; // ms
+    std::vector<double> Recorded; // ms, empty if the log was written without timing
+};
+
+double percentile(std::vector<double> values, const double P)
+{
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    const size_t INDEX{std::min(values.size() - 1, static_cast<size_t>(P * values.size()))};
+    return values[INDEX];
+}
+
+const char * name(const RequestLog::Type TYPE)
+{
+    switch (TYPE)
+    {
+    case RequestLog::Type::Clear:
+        return "clear";
+    case RequestLog::Type::Create:
+        return "create";
+    case RequestLog::Type::Remove:
+        return "remove";
+    case RequestLog::Type::Collides:
+        return "collides";
+    case RequestLog::Type::CollidesAny:
+        return "collides-any";
+    case RequestLog::Type::PathTo:
+        return "path-to";
+    case RequestLog::Type::Moved:
+        return "moved";
+    }
+    return "unknown";
+}
+
+class Replayer
+{
+    /////////
+    // data
+    /////////
+private:
+    imp::ObjectManager _manager;
+    std::optional<uint64_t> _seed;
+    std::map<std::pair<bool, uint64_t>, size_t> _ids; // recorded -> replayed
+
+    /////////
+    // constructors
+    /////////
+public:
+    explicit Replayer(std::optional<uint64_t> seed) : _seed{seed} {}
+
+    /////////
+    // methods
+    /////////
+public:
+    bool replay(const RequestLog::Record & record)
+    {
+        imp::io::BinaryReader reader(record.Payload.data(), record.Payload.size());
+        switch (record.RecordType)
+        {
+        case RequestLog::Type::Clear:
+            _manager.clear();
+            _ids.clear();
+            return true;
+        case RequestLog::Type::Create:
+            return create(reader);
+        case RequestLog::Type::Remove:
+            return remove(reader);
+        case RequestLog::Type::Collides:
+        case RequestLog::Type::CollidesAny:
+            return collides(reader);
+        case RequestLog::Type::PathTo:
+            return pathTo(reader);
+        case RequestLog::Type::Moved:
+            return moved(reader);
+        }
+        return false;
+    }
+
+private:
+    std::optional<size_t> movable(const int32_t RECORDED_ID)
+    {
+        auto it = _ids.find(std::make_pair(true, uint64_t(RECORDED_ID)));
+        if (it == _ids.end() || !_manager.hasMovable(it->second)) return std::nullopt;
+        return it->second;
+    }
+
+    bool create(imp::io::BinaryReader & reader)
+    {
+        uint8_t is_movable{0};
+        imp::Configuration transform;
+        std::vector<fcl::Vector3f> vertices;
+        std::vector<fcl::Triangle> triangles;
+        uint64_t recorded_id{0};
+        if (!reader.read(is_movable) || !BinaryCodec::read(reader, transform) ||
+            !BinaryCodec::read(reader, vertices, triangles) || !reader.read(recorded_id))
+            return false;
+
+        const size_t ID{_manager.add(is_movable, vertices, triangles, transform)};
+        _ids[std::make_pair(bool(is_movable), recorded_id)] = ID;
+        if (is_movable && _seed.has_value()) _manager.est(ID)->seed(_seed);
+        return true;
+    }
+
+    bool remove(imp::io::BinaryReader & reader)
+    {
+        std::vector<uint8_t> movables;
+        std::vector<uint64_t> ids;
+        if (!reader.read(movables) || !reader.read(ids) || movables.size() != ids.size())
+            return false;
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            auto it = _ids.find(std::make_pair(bool(movables[i]), ids[i]));
+            if (it == _ids.end()) continue;
+            _manager.remove(movables[i], it->second);
+            _ids.erase(it);
+        }
+        return true;
+    }
+
+    bool collides(imp::io::BinaryReader & reader)
+    {
+        int32_t recorded_id{0};
+        std::vector<imp::Configuration> transforms;
+        if (!reader.read(recorded_id) || !BinaryCodec::read(reader, transforms)) return false;
+
+        auto id{movable(recorded_id)};
+        if (!id.has_value()) return false;
+
+        int collision_count = 0;
+#pragma omp parallel for reduction(+ : collision_count)
+        for (int64_t i = 0; i < static_cast<int64_t>(transforms.size()); ++i)
+            collision_count += int(_manager.collides(id.value(), transforms[i]));
+        return true;
+    }
+
+    bool pathTo(imp::io::BinaryReader & reader)
+    {
+        int32_t recorded_id{0};
+        imp::Configuration root;
+        std::vector<imp::Configuration> u_path;
+        if (!reader.read(recorded_id) || !BinaryCodec::read(reader, root) ||
+            !BinaryCodec::read(reader, u_path))
+            return false;
+
+        auto id{movable(recorded_id)};
+        if (!id.has_value()) return false;
+        const size_t ID{id.value()};
+
+        auto [matchees, COLLISION_FREE_MATCHEE] = _manager.selectMatchees(ID, u_path);
+
+        auto wtree{_manager.wtree(ID)};
+        if (COLLISION_FREE_MATCHEE)
+        {
+            if (auto hit = wtree->roadmap(_manager, root, matchees))
+            {
+                wtree->moveTo(hit->Node);
+                return true;
+            }
+        }
+
+        _manager.est(ID)->explore(root, matchees, COLLISION_FREE_MATCHEE);
+        wtree->join(*_manager.est(ID));
+        return true;
+    }
+
+    bool moved(imp::io::BinaryReader & reader)
+    {
+        int32_t recorded_id{0};
+        imp::Configuration start, end;
+        if (!reader.read(recorded_id) || !BinaryCodec::read(reader, start) ||
+            !BinaryCodec::read(reader, end))
+            return false;
+
+        auto id{movable(recorded_id)};
+        if (!id.has_value()) return false;
+
+        _manager.wtree(id.value())->moveFromToInsert(start, end);
+        return true;
+    }
+};
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: imp-replay <log> [--seed <seed>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::optional<uint64_t> seed;
+    for (int i = 2; i + 1 < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--seed") seed = std::stoull(argv[++i]);
+    }
+
+    std::vector<RequestLog::Record> records;
+    if (!RequestLog::read(argv[1], records))
+    {
+        std::cerr << "imp-replay: " << argv[1] << " is not a (complete) request log" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // records are appended on completion, replay them in the order the requests started
+    std::stable_sort(records.begin(), records.end(),
+                     [](const auto & a, const auto & b) { return a.Timestamp < b.Timestamp; });
+
+    omp_set_num_threads(MAX_OMP_THREADS);
+
+    Replayer replayer(seed);
+    std::map<RequestLog::Type, Latencies> latencies;
+    size_t failed{0};
+
+    imp::time::Timer total;
+    for (const auto & record : records)
+    {
+        imp::time::Timer timer;
+        if (!replayer.replay(record))
+        {
+            failed++;
+            continue;
+        }
+
+        auto & latency{latencies[record.RecordType]};
+        latency.Replayed.emplace_back(
+            std::chrono::duration<double, std::milli>(timer.elapsed()).count());
+        if (record.Duration) latency.Recorded.emplace_back(record.Duration * 1e-6);
+    }
+
+    std::cout << records.size() << " records replayed in "
+              << std::chrono::duration<double>(total.elapsed()).count() << "s, " << failed
+              << " failed (malformed or unknown ids)\n\n";
+
+    std::cout << std::left << std::setw(14) << "type" << std::right << std::setw(8) << "count"
+              << std::setw(12) << "p50 ms" << std::setw(12) << "p90 ms" << std::setw(12)
+              << "p99 ms" << std::setw(12) << "max ms" << std::setw(16) << "recorded p50"
+              << std::setw(16) << "recorded p99" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto & [type, latency] : latencies)
+    {
+        std::cout << std::left << std::setw(14) << name(type) << std::right << std::setw(8)
+                  << latency.Replayed.size() << std::setw(12)
+                  << percentile(latency.Replayed, 0.5) << std::setw(12)
+                  << percentile(latency.Replayed, 0.9) << std::setw(12)
+                  << percentile(latency.Replayed, 0.99) << std::setw(12)
+                  << percentile(latency.Replayed, 1.0);
+        if (latency.Recorded.empty())
+            std::cout << std::setw(16) << "-" << std::setw(16) << "-";
+        else
+            std::cout << std::setw(16) << percentile(latency.Recorded, 0.5) << std::setw(16)
+                      << percentile(latency.Recorded, 0.99);
+        std::cout << "\n";
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+import struct
+import sys
+import time
+
+import requests
+
+# Replays a request log (RECORD_REQUESTS) against a running imp-server over its binary
+# endpoints and reports latency percentiles per request type. Path-to requests are completed
+# with /path-to-get-bin, so their latency covers the exploration. Records are replayed in the
+# order the requests started.
+#
+# usage: python replay.py <log> [host]
+
+host = sys.argv[2] if len(sys.argv) > 2 else "http://192.168.188.99:8000"
+
+MAGIC = b"IMPR"
+BODY_HEADER = b"IMPB" + struct.pack("<I", 1)
+OCTET = {"Content-Type": "application/octet-stream"}
+TYPES = ["clear", "create", "remove", "collides", "collides-any", "path-to", "moved"]
+POSE = [
+    "position_x",
+    "position_y",
+    "position_z",
+    "rotation_w",
+    "rotation_x",
+    "rotation_y",
+    "rotation_z",
+]
+
+
+def read_log(filename):
+    data = open(filename, "rb").read()
+    if data[:4] != MAGIC or struct.unpack_from("<I", data, 4)[0] != 1:
+        raise ValueError(filename + " is not a request log")
+
+    records = []
+    offset = 8
+    while offset < len(data):
+        kind, timestamp, duration, size = struct.unpack_from("<BQQQ", data, offset)
+        offset += struct.calcsize("<BQQQ")
+        records.append((timestamp, TYPES[kind], duration, data[offset : offset + size]))
+        offset += size
+
+    # records are appended on completion, sorted is stable
+    return [record[1:] for record in sorted(records, key=lambda record: record[0])]
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p * len(values)))] if values else 0.0
+
+
+ids = {}  # (movable, recorded id) -> replayed id
+latencies = {}
+failed = 0
+
+requests.request("GET", host + "/clear")
+
+for kind, duration, payload in read_log(sys.argv[1]):
+    start = time.perf_counter()
+
+    if kind == "clear":
+        response = requests.request("GET", host + "/clear")
+        ids.clear()
+    elif kind == "create":
+        # the recorded id trails the /create-bin body
+        recorded = struct.unpack_from("<Q", payload, len(payload) - 8)[0]
+        movable = bool(payload[0])
+        response = requests.request(
+            "PUT", host + "/create-bin", data=BODY_HEADER + payload[:-8], headers=OCTET
+        )
+        if response.ok:
+            ids[(movable, recorded)] = response.json()["id"]
+    elif kind == "remove":
+        count = struct.unpack_from("<Q", payload, 0)[0]
+        movables = list(payload[8 : 8 + count])
+        recorded = struct.unpack_from("<%dQ" % count, payload, 16 + count)
+        keys = [(bool(m), r) for m, r in zip(movables, recorded) if (bool(m), r) in ids]
+        trash = [(key[0], ids.pop(key)) for key in keys]
+        response = requests.request(
+            "PUT",
+            host + "/trashes",
+            json={"movables": [m for m, _ in trash], "ids": [i for _, i in trash]},
+        )
+    elif kind == "moved":
+        recorded = struct.unpack_from("<i", payload, 0)[0]
+        start = struct.unpack_from("<7f", payload, 4)
+        end = struct.unpack_from("<7f", payload, 32)
+        body = {"movable_id": ids.get((True, recorded), -1)}
+        body.update({"start_" + key: value for key, value in zip(POSE, start)})
+        body.update({"end_" + key: value for key, value in zip(POSE, end)})
+        response = requests.request("PUT", host + "/moved", json=body)
+    else:
+        recorded = struct.unpack_from("<i", payload, 0)[0]
+        body = BODY_HEADER + struct.pack("<i", ids.get((True, recorded), -1)) + payload[4:]
+        if kind == "path-to":
+            response = requests.request("PUT", host + "/path-to-bin", data=body, headers=OCTET)
+            if response.ok:
+                response = requests.request(
+                    "PUT",
+                    host + "/path-to-get-bin",
+                    json={"path_to_request_id": response.json()["path_to_request_id"]},
+                )
+        else:
+            response = requests.request(
+                "PUT", host + "/collides-any-bin", data=body, headers=OCTET
+            )
+
+    if not response.ok:
+        failed += 1
+        continue
+
+    replayed, recorded = latencies.setdefault(kind, ([], []))
+    replayed.append((time.perf_counter() - start) * 1e3)
+    if duration:
+        recorded.append(duration * 1e-6)
+
+print(
+    "%-14s%8s%12s%12s%12s%12s%16s"
+    % ("type", "count", "p50 ms", "p90 ms", "p99 ms", "max ms", "recorded p50")
+)
+for kind, (replayed, recorded) in latencies.items():
+    print(
+        "%-14s%8d%12.3f%12.3f%12.3f%12.3f%16s"
+        % (
+            kind,
+            len(replayed),
+            percentile(replayed, 0.5),
+            percentile(replayed, 0.9),
+            percentile(replayed, 0.99),
+            percentile(replayed, 1.0),
+            "%.3f" % percentile(recorded, 0.5) if recorded else "-",
+        )
+    )
+print("%d requests failed" % failed)